@@ -1,10 +1,12 @@
 set(GAMESHAREDLIST
     ${GAMELOGIC_DIR}/shared/bg_alloc.cpp
+    ${GAMELOGIC_DIR}/shared/bg_configcache.cpp
     ${GAMELOGIC_DIR}/shared/bg_gameplay.h
     ${GAMELOGIC_DIR}/shared/bg_local.h
     ${GAMELOGIC_DIR}/shared/bg_misc.cpp
     ${GAMELOGIC_DIR}/shared/bg_parse.cpp
     ${GAMELOGIC_DIR}/shared/bg_pmove.cpp
+    ${GAMELOGIC_DIR}/shared/bg_pmovereplay.cpp
     ${GAMELOGIC_DIR}/shared/bg_public.h
     ${GAMELOGIC_DIR}/shared/bg_slidemove.cpp
     ${GAMELOGIC_DIR}/shared/bg_teamprogress.cpp
@@ -12,6 +14,12 @@ set(GAMESHAREDLIST
     ${GAMELOGIC_DIR}/shared/bg_voice.cpp
 )
 
+set(PMOVEREPLAYLIST
+    ${GAMELOGIC_DIR}/utils/pmovereplay/pmovereplay.cpp
+
+    ${GAMESHAREDLIST}
+)
+
 set(CGAMELIST
     ${GAMELOGIC_DIR}/cgame/cg_animation.cpp
     ${GAMELOGIC_DIR}/cgame/cg_animmapobj.cpp
@@ -118,6 +126,7 @@ set(SGAMELIST
     ${GAMELOGIC_DIR}/sgame/sg_definitions.h
     ${GAMELOGIC_DIR}/sgame/sg_entities.cpp
     ${GAMELOGIC_DIR}/sgame/sg_entities.h
+    ${GAMELOGIC_DIR}/sgame/sg_eventlog.cpp
     ${GAMELOGIC_DIR}/sgame/sg_extern.h
     ${GAMELOGIC_DIR}/sgame/sg_local.h
     ${GAMELOGIC_DIR}/sgame/sg_main.cpp
@@ -126,6 +135,7 @@ set(SGAMELIST
     ${GAMELOGIC_DIR}/sgame/sg_momentum.cpp
     ${GAMELOGIC_DIR}/sgame/sg_namelog.cpp
     ${GAMELOGIC_DIR}/sgame/sg_physics.cpp
+    ${GAMELOGIC_DIR}/sgame/sg_pmovereplay.cpp
     ${GAMELOGIC_DIR}/sgame/sg_public.h
     ${GAMELOGIC_DIR}/sgame/sg_session.cpp
     ${GAMELOGIC_DIR}/sgame/sg_spawn.cpp
@@ -143,6 +153,7 @@ set(SGAMELIST
     ${GAMELOGIC_DIR}/sgame/sg_struct.h
     ${GAMELOGIC_DIR}/sgame/sg_svcmds.cpp
     ${GAMELOGIC_DIR}/sgame/sg_team.cpp
+    ${GAMELOGIC_DIR}/sgame/sg_threats.cpp
     ${GAMELOGIC_DIR}/sgame/sg_trapcalls.h
     ${GAMELOGIC_DIR}/sgame/sg_typedef.h
     ${GAMELOGIC_DIR}/sgame/sg_utils.cpp
@@ -1350,8 +1350,24 @@ typedef struct server_s
 	int maxClients;
 	char *mapName;
 	char *addr;
+
+	char *filterName; // color-stripped and lowercased name, for filtering and sorting
+	uint32_t infoHash; // of the info string and ping it was last updated from
+	bool inUse;
+	bool seen; // listed by the engine during the last refresh
+	bool listed; // has a row in the data source table
+	int row; // in serverRows, while listed
 } server_t;
 
+typedef enum
+{
+  SERVERSORT_NONE,
+  SERVERSORT_PING,
+  SERVERSORT_NAME,
+  SERVERSORT_PLAYERS,
+  SERVERSORT_MAP
+} serverSortKey_t;
+
 
 
 typedef struct resolution_s
@@ -1387,6 +1403,10 @@ typedef struct
 	server_t servers[ AS_FAVORITES + 1 ][ MAX_SERVERS ];
 	int serverCount[ AS_FAVORITES + 1 ];
 	int serverIndex[ AS_FAVORITES + 1 ];
+	int serverRows[ AS_FAVORITES + 1 ][ MAX_SERVERS ];
+	int serverRowCount[ AS_FAVORITES + 1 ];
+	serverSortKey_t serverSortKey[ AS_FAVORITES + 1 ];
+	char serverFilter[ AS_FAVORITES + 1 ][ MAX_INFO_VALUE ];
 	bool buildingServerInfo;
 	bool retrievingServers;
 
@@ -1725,6 +1745,10 @@ typedef struct
 	// corpse info
 	clientInfo_t corpseinfo[ MAX_CLIENTS ];
 
+	// class and weapon media are registered when first needed, see cg_lazyMedia
+	bool         lazyMedia;
+	team_t       lazyMediaTeam;
+
 	void         *capturedItem;
 	qhandle_t    activeCursor;
 
@@ -1837,6 +1861,9 @@ extern  vmCvar_t            cg_animSpeed;
 extern  vmCvar_t            cg_debugAnim;
 extern  vmCvar_t            cg_debugPosition;
 extern  vmCvar_t            cg_debugEvents;
+extern  vmCvar_t            cg_debugTraceStats;
+extern  vmCvar_t            cg_zoneWeightCache;
+extern  vmCvar_t            cg_lazyMedia;
 extern  vmCvar_t            cg_errorDecay;
 extern  vmCvar_t            cg_nopredict;
 extern  vmCvar_t            cg_debugMove;
@@ -1971,6 +1998,10 @@ const char *CG_Args();
 void       CG_StartMusic();
 
 void       CG_NotifyHooks();
+void       CG_RegisterClassMedia( int class_ );
+void       CG_RegisterWeaponMedia( int weapon );
+void       CG_RegisterSnapshotMedia( const snapshot_t *snap );
+void       CG_UpdateLazyMedia();
 void       CG_UpdateCvars();
 
 int        CG_CrosshairPlayer();
@@ -2392,6 +2423,7 @@ bool Rocket_GetEvent(std::string& cmdText);
 void Rocket_DeleteEvent();
 void Rocket_RegisterDataSource( const char *name );
 void Rocket_DSAddRow( const char *name, const char *table, const char *data );
+void Rocket_DSInsertRow( const char *name, const char *table, const int row, const char *data );
 void Rocket_DSChangeRow( const char *name, const char *table, const int row, const char *data );
 void Rocket_DSRemoveRow( const char *name, const char *table, const int row );
 void Rocket_DSClearTable( const char *name, const char *table );
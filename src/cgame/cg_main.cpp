@@ -64,6 +64,9 @@ vmCvar_t        cg_draw2D;
 vmCvar_t        cg_debugAnim;
 vmCvar_t        cg_debugPosition;
 vmCvar_t        cg_debugEvents;
+vmCvar_t        cg_debugTraceStats;
+vmCvar_t        cg_zoneWeightCache;
+vmCvar_t        cg_lazyMedia;
 vmCvar_t        cg_errorDecay;
 vmCvar_t        cg_nopredict;
 vmCvar_t        cg_debugMove;
@@ -240,6 +243,9 @@ static const cvarTable_t cvarTable[] =
 	{ &cg_debugAnim,                   "cg_debuganim",                   "0",            CVAR_CHEAT                   },
 	{ &cg_debugPosition,               "cg_debugposition",               "0",            CVAR_CHEAT                   },
 	{ &cg_debugEvents,                 "cg_debugevents",                 "0",            CVAR_CHEAT                   },
+	{ &cg_debugTraceStats,             "cg_debugTraceStats",             "0",            CVAR_CHEAT                   },
+	{ &cg_zoneWeightCache,             "cg_zoneWeightCache",             "1",            0                            },
+	{ &cg_lazyMedia,                   "cg_lazyMedia",                   "0",            CVAR_ARCHIVE                 },
 	{ &cg_errorDecay,                  "cg_errordecay",                  "100",          0                            },
 	{ &cg_nopredict,                   "cg_nopredict",                   "0",            0                            },
 	{ &cg_debugMove,                   "cg_debugMove",                   "0",            0                            },
@@ -792,12 +798,6 @@ static void CG_UpdateLoadingProgress( loadingBar_t progressBar, float progress,
 	trap_UpdateScreen();
 }
 
-static void CG_UpdateMediaFraction( float newFract )
-{
-	cg.mediaFraction = newFract;
-	trap_UpdateScreen();
-}
-
 enum {
 	LOAD_START = 1,
 	LOAD_TRAILS,
@@ -814,29 +814,112 @@ enum {
 	LOAD_DONE
 } typedef cgLoadingStep_t;
 
+// share of the media loading bar used by each step
+static const float cg_loadingShares[ LOAD_BUILDINGS - LOAD_TRAILS ] =
+{
+	0.05f, // LOAD_TRAILS
+	0.03f, // LOAD_PARTICLES
+	0.52f, // LOAD_SOUNDS
+	0.03f, // LOAD_GEOMETRY
+	0.17f, // LOAD_ASSETS
+	0.10f, // LOAD_CONFIGS
+	0.05f, // LOAD_WEAPONS
+	0.00f, // LOAD_UPGRADES
+	0.05f, // LOAD_CLASSES
+};
+
+static const char *const cg_loadingStepNames[ LOAD_DONE ] =
+{
+	nullptr,
+	"start",
+	"trails",
+	"particles",
+	"sounds",
+	"geometry",
+	"assets",
+	"configs",
+	"weapons",
+	"upgrades",
+	"classes",
+	"buildings",
+	"remaining",
+};
+
+static int cg_loadingTimes[ LOAD_DONE ];
+
+/*
+=================
+CG_LoadingFraction
+
+Progress of the media bar when a step starts.
+=================
+*/
+static float CG_LoadingFraction( cgLoadingStep_t step )
+{
+	float fraction = 0.0f;
+
+	for ( int i = LOAD_TRAILS; i < step && i < LOAD_BUILDINGS; i++ )
+	{
+		fraction += cg_loadingShares[ i - LOAD_TRAILS ];
+	}
+
+	return std::min( fraction, 1.0f );
+}
+
+/*
+=================
+CG_UpdateMediaFraction
+
+Reports progress within a step of the media bar.
+=================
+*/
+static void CG_UpdateMediaFraction( cgLoadingStep_t step, float stepFraction )
+{
+	cg.mediaFraction = CG_LoadingFraction( step ) + stepFraction * cg_loadingShares[ step - LOAD_TRAILS ];
+	trap_UpdateScreen();
+}
+
+/*
+=================
+CG_PrintLoadingTimes
+
+Prints how long each loading step took, with developer set.
+=================
+*/
+static void CG_PrintLoadingTimes( int totalTime )
+{
+	if ( !atoi( Cvar::GetValue( "developer" ).c_str() ) )
+	{
+		return;
+	}
+
+	Log::Notice( "loaded in %dms", totalTime );
+
+	for ( int i = LOAD_START; i < LOAD_DONE; i++ )
+	{
+		Log::Notice( "  %-10s %dms", cg_loadingStepNames[ i ], cg_loadingTimes[ i ] );
+	}
+}
+
 static void CG_UpdateLoadingStep( cgLoadingStep_t step )
 {
-#if 0
 	static int startTime = 0;
 	static int lastStepTime = 0;
+	static cgLoadingStep_t lastStep;
 	const int thisStepTime = trap_Milliseconds();
 
-	switch (step) {
-		case LOAD_START:
-			startTime = thisStepTime;
-			Log::Notice("^4%%^5 Start loading.");
-			break;
-		case LOAD_DONE:
-			Log::Notice("^4%%^5 Done loading everything after %is (%ims).",
-					(thisStepTime - startTime)/1000, (thisStepTime - startTime));
-			break;
-		default:
-			Log::Notice("^4%%^5 Done with Step %i after %is (%ims)… Starting Step %i",
-					step - 1, (thisStepTime - lastStepTime)/1000, (thisStepTime - lastStepTime), step );
-			break;
+	if ( step == LOAD_START )
+	{
+		startTime = thisStepTime;
+		memset( cg_loadingTimes, 0, sizeof( cg_loadingTimes ) );
+	}
+	else
+	{
+		cg_loadingTimes[ lastStep ] += thisStepTime - lastStepTime;
 	}
+
+	lastStep = step;
 	lastStepTime = thisStepTime;
-#endif
 
 	switch (step) {
 		case LOAD_START:
@@ -845,29 +928,29 @@ static void CG_UpdateLoadingStep( cgLoadingStep_t step )
 			break;
 
 		case LOAD_TRAILS:
-			CG_UpdateLoadingProgress( LOADBAR_MEDIA, 0.0f, choose("Tracking your movements", "Letting out the magic smoke", nullptr) );
+			CG_UpdateLoadingProgress( LOADBAR_MEDIA, CG_LoadingFraction( step ), choose("Tracking your movements", "Letting out the magic smoke", nullptr) );
 			break;
 		case LOAD_PARTICLES:
-			CG_UpdateLoadingProgress( LOADBAR_MEDIA, 0.05f, choose("Collecting bees for the hives", "Initialising fireworks", "Causing electrical faults", nullptr) );
+			CG_UpdateLoadingProgress( LOADBAR_MEDIA, CG_LoadingFraction( step ), choose("Collecting bees for the hives", "Initialising fireworks", "Causing electrical faults", nullptr) );
 			break;
 		case LOAD_SOUNDS:
-			CG_UpdateLoadingProgress( LOADBAR_MEDIA, 0.08f, choose("Recording granger purring", "Generating annoying noises", nullptr) );
+			CG_UpdateLoadingProgress( LOADBAR_MEDIA, CG_LoadingFraction( step ), choose("Recording granger purring", "Generating annoying noises", nullptr) );
 			break;
 		case LOAD_GEOMETRY:
-			CG_UpdateLoadingProgress( LOADBAR_MEDIA, 0.60f, choose("Hello World!", "Making a scene.", nullptr) );
+			CG_UpdateLoadingProgress( LOADBAR_MEDIA, CG_LoadingFraction( step ), choose("Hello World!", "Making a scene.", nullptr) );
 			break;
 		case LOAD_ASSETS:
-			CG_UpdateLoadingProgress( LOADBAR_MEDIA, 0.63f, choose("Taking pictures of the world", "Using your laptop's camera", "Adding texture to concrete", "Drawing smiley faces", nullptr) );
+			CG_UpdateLoadingProgress( LOADBAR_MEDIA, CG_LoadingFraction( step ), choose("Taking pictures of the world", "Using your laptop's camera", "Adding texture to concrete", "Drawing smiley faces", nullptr) );
 			break;
 		case LOAD_CONFIGS:
-			CG_UpdateLoadingProgress( LOADBAR_MEDIA, 0.80f, choose("Reading the manual", "Looking at blueprints", nullptr) );
+			CG_UpdateLoadingProgress( LOADBAR_MEDIA, CG_LoadingFraction( step ), choose("Reading the manual", "Looking at blueprints", nullptr) );
 			break;
 		case LOAD_WEAPONS:
-			CG_UpdateLoadingProgress( LOADBAR_MEDIA, 0.90f, choose("Setting up the armoury", "Sharpening the aliens' claws", "Overloading lucifer cannons", nullptr) );
+			CG_UpdateLoadingProgress( LOADBAR_MEDIA, CG_LoadingFraction( step ), choose("Setting up the armoury", "Sharpening the aliens' claws", "Overloading lucifer cannons", nullptr) );
 			break;
 		case LOAD_UPGRADES:
 		case LOAD_CLASSES:
-			CG_UpdateLoadingProgress( LOADBAR_MEDIA, 0.95f, choose("Charging battery packs", "Replicating alien DNA", "Packing tents for jetcampers", nullptr) );
+			CG_UpdateLoadingProgress( LOADBAR_MEDIA, CG_LoadingFraction( step ), choose("Charging battery packs", "Replicating alien DNA", "Packing tents for jetcampers", nullptr) );
 			break;
 		case LOAD_BUILDINGS:
 			cg.mediaFraction = 1.0f;
@@ -875,6 +958,7 @@ static void CG_UpdateLoadingStep( cgLoadingStep_t step )
 			break;
 
 		case LOAD_DONE:
+			CG_PrintLoadingTimes( thisStepTime - startTime );
 			cg.mediaFraction = cg.charModelFraction = cg.buildablesFraction = 1.0f;
 			Q_strncpyz(cg.currentLoadingLabel, "Done!", sizeof( cg.currentLoadingLabel ) );
 			trap_UpdateScreen();
@@ -1163,7 +1247,7 @@ static void CG_RegisterGraphics()
 
 	cgs.media.scopeShader = trap_R_RegisterShader( "scope", (RegisterShaderFlags_t) ( RSF_DEFAULT | RSF_NOMIP ) );
 
-	CG_UpdateMediaFraction( 0.7f );
+	CG_UpdateMediaFraction( LOAD_ASSETS, 0.4f );
 
 	memset( cg_weapons, 0, sizeof( cg_weapons ) );
 	memset( cg_upgrades, 0, sizeof( cg_upgrades ) );
@@ -1266,7 +1350,7 @@ static void CG_RegisterGraphics()
 		cgs.gameModels[ i ] = trap_R_RegisterModel( modelName );
 	}
 
-	CG_UpdateMediaFraction( 0.75f );
+	CG_UpdateMediaFraction( LOAD_ASSETS, 0.7f );
 
 	// register all the server specified shaders
 	for ( i = 1; i < MAX_GAME_SHADERS; i++ )
@@ -1284,7 +1368,7 @@ static void CG_RegisterGraphics()
 							     (RegisterShaderFlags_t) RSF_DEFAULT);
 	}
 
-	CG_UpdateMediaFraction( 0.77f );
+	CG_UpdateMediaFraction( LOAD_ASSETS, 0.8f );
 
 	// register all the server specified grading textures
 	// starting with the world wide one
@@ -1300,7 +1384,7 @@ static void CG_RegisterGraphics()
 		CG_RegisterReverb( i, CG_ConfigString( CS_REVERB_EFFECTS + i ) );
 	}
 
-	CG_UpdateMediaFraction( 0.79f );
+	CG_UpdateMediaFraction( LOAD_ASSETS, 0.95f );
 
 	// register all the server specified particle systems
 	for ( i = 1; i < MAX_GAME_PARTICLE_SYSTEMS; i++ )
@@ -1340,6 +1424,189 @@ void CG_BuildSpectatorString()
 	}
 }
 
+/*
+=======================
+Lazy media registration
+
+With cg_lazyMedia, the models, skins, animations and sounds of classes and
+weapons are not loaded with the map. They are registered when the player
+joins a team, or by CG_RegisterSnapshotMedia when a snapshot first has them,
+and the remaining ones of the player's team are loaded one per frame, in the
+order they unlock.
+=======================
+*/
+
+void CG_RegisterClassMedia( int class_ )
+{
+	if ( class_ <= PCL_NONE || class_ >= PCL_NUM_CLASSES || cgs.corpseinfo[ class_ ].infoValid )
+	{
+		return;
+	}
+
+	CG_PrecacheClientInfo( (class_t) class_, BG_ClassModelConfig( class_ )->modelName,
+	                       BG_ClassModelConfig( class_ )->skinName );
+}
+
+void CG_RegisterWeaponMedia( int weapon )
+{
+	if ( weapon <= WP_NONE || weapon >= WP_NUM_WEAPONS || cg_weapons[ weapon ].registered )
+	{
+		return;
+	}
+
+	CG_RegisterWeapon( weapon );
+}
+
+static bool CG_LazyMediaTeam( team_t itemTeam, team_t team )
+{
+	// spectators load both teams
+	return team == TEAM_NONE ? itemTeam != TEAM_NONE : itemTeam == team;
+}
+
+/*
+=================
+CG_PrefetchNextMedia
+
+Registers the class or weapon of the team that unlocks first, returns false
+once everything of the team is registered.
+=================
+*/
+static bool CG_PrefetchNextMedia( team_t team )
+{
+	int best = -1, bestThreshold = INT_MAX;
+	bool bestIsClass = false;
+
+	for ( int i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++ )
+	{
+		if ( !cgs.corpseinfo[ i ].infoValid && CG_LazyMediaTeam( BG_Class( i )->team, team ) &&
+		     BG_Class( i )->unlockThreshold < bestThreshold )
+		{
+			best = i;
+			bestThreshold = BG_Class( i )->unlockThreshold;
+			bestIsClass = true;
+		}
+	}
+
+	for ( int i = WP_NONE + 1; i < WP_NUM_WEAPONS; i++ )
+	{
+		if ( !cg_weapons[ i ].registered && CG_LazyMediaTeam( BG_Weapon( i )->team, team ) &&
+		     BG_Weapon( i )->unlockThreshold < bestThreshold )
+		{
+			best = i;
+			bestThreshold = BG_Weapon( i )->unlockThreshold;
+			bestIsClass = false;
+		}
+	}
+
+	if ( best < 0 )
+	{
+		return false;
+	}
+
+	if ( bestIsClass )
+	{
+		CG_RegisterClassMedia( best );
+	}
+	else
+	{
+		CG_RegisterWeaponMedia( best );
+	}
+
+	return true;
+}
+
+/*
+=================
+CG_RegisterSnapshotMedia
+
+Registers the classes and weapons of a new snapshot before its entities and
+events are processed. This is the only place that registers what others use,
+everything that draws or plays their media can rely on it being there.
+=================
+*/
+void CG_RegisterSnapshotMedia( const snapshot_t *snap )
+{
+	if ( !cgs.lazyMedia )
+	{
+		return;
+	}
+
+	CG_RegisterClassMedia( snap->ps.stats[ STAT_CLASS ] );
+	CG_RegisterWeaponMedia( snap->ps.weapon );
+
+	for ( const entityState_t &es : snap->entities )
+	{
+		switch ( es.eType )
+		{
+			case entityType_t::ET_PLAYER:
+				CG_RegisterClassMedia( ( es.misc >> 8 ) & 0xFF );
+				CG_RegisterWeaponMedia( es.weapon );
+				break;
+
+			case entityType_t::ET_CORPSE:
+				CG_RegisterClassMedia( es.clientNum );
+				break;
+
+			case entityType_t::ET_MISSILE:
+				CG_RegisterWeaponMedia( es.weapon );
+				break;
+
+			default:
+				// the impacts and tracers of weapons
+				if ( es.eType > entityType_t::ET_EVENTS )
+				{
+					CG_RegisterWeaponMedia( es.weapon );
+				}
+
+				break;
+		}
+	}
+}
+
+/*
+=================
+CG_UpdateLazyMedia
+
+Called every frame with a valid snapshot, loads what the player's team may
+need next.
+=================
+*/
+void CG_UpdateLazyMedia()
+{
+	playerState_t *ps = &cg.snap->ps;
+	team_t        team = (team_t) ps->persistant[ PERS_TEAM ];
+	int           i;
+
+	if ( !cgs.lazyMedia )
+	{
+		return;
+	}
+
+	if ( team != cgs.lazyMediaTeam )
+	{
+		cgs.lazyMediaTeam = team;
+
+		// everything that can be bought or evolved to right away
+		for ( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++ )
+		{
+			if ( BG_Class( i )->team == team && BG_ClassUnlocked( i ) && !BG_ClassDisabled( i ) )
+			{
+				CG_RegisterClassMedia( i );
+			}
+		}
+
+		for ( i = WP_NONE + 1; i < WP_NUM_WEAPONS; i++ )
+		{
+			if ( BG_Weapon( i )->team == team && BG_WeaponUnlocked( i ) && !BG_WeaponDisabled( i ) )
+			{
+				CG_RegisterWeaponMedia( i );
+			}
+		}
+	}
+
+	CG_PrefetchNextMedia( team );
+}
+
 /*
 ===================
 CG_RegisterClients
@@ -1353,7 +1620,7 @@ static void CG_RegisterClients()
 	cg.charModelFraction = 0.0f;
 
 	//precache all the models/sounds/etc
-	for ( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++ )
+	for ( i = PCL_NONE + 1; i < PCL_NUM_CLASSES && !cgs.lazyMedia; i++ )
 	{
 		CG_PrecacheClientInfo( (class_t) i, BG_ClassModelConfig( i )->modelName,
 		                       BG_ClassModelConfig( i )->skinName );
@@ -1497,6 +1764,9 @@ void CG_Init( int serverMessageNum, int clientNum, glconfig_t gl, GameStateCSs g
 	CG_UpdateLoadingStep( LOAD_START );
 	cg.clientNum = clientNum;
 
+	cgs.lazyMedia = cg_lazyMedia.integer != 0;
+	cgs.lazyMediaTeam = NUM_TEAMS;
+
 	cgs.processedSnapshotNum = serverMessageNum;
 
 	// get the rendering configuration from the client system
@@ -31,6 +31,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "cg_local.h"
 
+#include <algorithm>
+
 static  pmove_t   cg_pmove;
 
 static  int       cg_numSolidEntities;
@@ -38,6 +40,299 @@ static  centity_t *cg_solidEntities[ MAX_ENTITIES_IN_SNAPSHOT ];
 static  int       cg_numTriggerEntities;
 static  centity_t *cg_triggerEntities[ MAX_ENTITIES_IN_SNAPSHOT ];
 
+/*
+The solid entities that can't move far from their snapshot positions are
+sorted into a grid of cells on the horizontal plane, so traces only test the
+entities close to them. Brush models and entities that are moving on their
+own or riding a mover are always tested.
+*/
+
+#define SOLID_GRID_CELL_SIZE   256.0f
+#define SOLID_GRID_MAX_SIDE    64
+#define SOLID_GRID_MAX_SPAN    16  // entities covering more cells are always tested
+#define SOLID_GRID_MAX_QUERY   64  // traces covering more cells test every entity
+#define SOLID_GRID_SLACK       8.0f
+
+static struct
+{
+	vec3_t origin;
+	int    width, height;
+
+	// entities of each cell, cell c holds items[ start[ c ] ] to items[ start[ c + 1 ] - 1 ]
+	int    start[ SOLID_GRID_MAX_SIDE * SOLID_GRID_MAX_SIDE + 1 ];
+	int    items[ MAX_ENTITIES_IN_SNAPSHOT * SOLID_GRID_MAX_SPAN ];
+
+	int    numUnindexed;
+	int    unindexed[ MAX_ENTITIES_IN_SNAPSHOT ];
+
+	// bounds of the indexed entities, empty for the others
+	vec3_t mins[ MAX_ENTITIES_IN_SNAPSHOT ];
+	vec3_t maxs[ MAX_ENTITIES_IN_SNAPSHOT ];
+
+	// avoids returning an entity twice in a query
+	int    stamp;
+	int    stamps[ MAX_ENTITIES_IN_SNAPSHOT ];
+} cg_solidGrid;
+
+static struct
+{
+	int time;
+	int traces;
+	int fallbacks;
+	int candidates;
+	int tested;
+} cg_traceStats;
+
+/*
+====================
+CG_SolidGridBounds
+
+Computes bounds that contain the entity wherever it is drawn until the next
+snapshot. Returns false if there are none.
+====================
+*/
+static bool CG_SolidGridBounds( centity_t *cent, vec3_t mins, vec3_t maxs )
+{
+	entityState_t *ent = &cent->currentState;
+	vec3_t        bmins, bmaxs;
+	int           x, zd, zu;
+
+	if ( ent->solid == SOLID_BMODEL )
+	{
+		return false;
+	}
+
+	if ( ( ent->pos.trType != trType_t::TR_STATIONARY && ent->pos.trType != trType_t::TR_INTERPOLATE ) ||
+	     ( cent->nextState.pos.trType != trType_t::TR_STATIONARY && cent->nextState.pos.trType != trType_t::TR_INTERPOLATE ) )
+	{
+		return false;
+	}
+
+	// the position of entities standing on movers gets adjusted
+	if ( ent->groundEntityNum != ENTITYNUM_NONE && ent->groundEntityNum != ENTITYNUM_WORLD &&
+	     cg_entities[ ent->groundEntityNum ].currentState.eType == entityType_t::ET_MOVER )
+	{
+		return false;
+	}
+
+	// encoded bbox, same as in CG_ClipMoveToEntities
+	x = ( ent->solid & 255 );
+	zd = ( ( ent->solid >> 8 ) & 255 );
+	zu = ( ( ent->solid >> 16 ) & 255 ) - 32;
+
+	bmins[ 0 ] = bmins[ 1 ] = -x - SOLID_GRID_SLACK;
+	bmaxs[ 0 ] = bmaxs[ 1 ] = x + SOLID_GRID_SLACK;
+	bmins[ 2 ] = -zd - SOLID_GRID_SLACK;
+	bmaxs[ 2 ] = zu + SOLID_GRID_SLACK;
+
+	// the entity is drawn between these positions
+	ClearBounds( mins, maxs );
+	AddPointToBounds( cent->lerpOrigin, mins, maxs );
+	AddPointToBounds( ent->pos.trBase, mins, maxs );
+	AddPointToBounds( cent->nextState.pos.trBase, mins, maxs );
+
+	VectorAdd( mins, bmins, mins );
+	VectorAdd( maxs, bmaxs, maxs );
+
+	return true;
+}
+
+/*
+====================
+CG_SolidGridCells
+
+Gets the range of cells covered by bounds, clamped to the grid.
+====================
+*/
+static void CG_SolidGridCells( const vec3_t mins, const vec3_t maxs, int cells[ 4 ] )
+{
+	BG_GridCells( cg_solidGrid.origin, SOLID_GRID_CELL_SIZE, mins, maxs, cells );
+
+	cells[ 0 ] = Math::Clamp( cells[ 0 ], 0, cg_solidGrid.width - 1 );
+	cells[ 1 ] = Math::Clamp( cells[ 1 ], 0, cg_solidGrid.height - 1 );
+	cells[ 2 ] = Math::Clamp( cells[ 2 ], 0, cg_solidGrid.width - 1 );
+	cells[ 3 ] = Math::Clamp( cells[ 3 ], 0, cg_solidGrid.height - 1 );
+}
+
+/*
+====================
+CG_BuildSolidGrid
+
+Sorts the solid entities into the grid.
+====================
+*/
+static void CG_BuildSolidGrid()
+{
+	static int count[ SOLID_GRID_MAX_SIDE * SOLID_GRID_MAX_SIDE ];
+	bool       indexed[ MAX_ENTITIES_IN_SNAPSHOT ];
+	int        cells[ 4 ];
+	vec3_t     mins, maxs;
+	int        i, x, y, numCells;
+
+	cg_solidGrid.numUnindexed = 0;
+	ClearBounds( mins, maxs );
+
+	for ( i = 0; i < cg_numSolidEntities; i++ )
+	{
+		indexed[ i ] = CG_SolidGridBounds( cg_solidEntities[ i ], cg_solidGrid.mins[ i ], cg_solidGrid.maxs[ i ] );
+
+		if ( indexed[ i ] )
+		{
+			AddPointToBounds( cg_solidGrid.mins[ i ], mins, maxs );
+			AddPointToBounds( cg_solidGrid.maxs[ i ], mins, maxs );
+		}
+	}
+
+	VectorCopy( mins, cg_solidGrid.origin );
+	cg_solidGrid.width = Math::Clamp( ( int )( ( maxs[ 0 ] - mins[ 0 ] ) / SOLID_GRID_CELL_SIZE ) + 1, 1, SOLID_GRID_MAX_SIDE );
+	cg_solidGrid.height = Math::Clamp( ( int )( ( maxs[ 1 ] - mins[ 1 ] ) / SOLID_GRID_CELL_SIZE ) + 1, 1, SOLID_GRID_MAX_SIDE );
+	numCells = cg_solidGrid.width * cg_solidGrid.height;
+
+	memset( count, 0, numCells * sizeof( count[ 0 ] ) );
+
+	for ( i = 0; i < cg_numSolidEntities; i++ )
+	{
+		if ( indexed[ i ] )
+		{
+			CG_SolidGridCells( cg_solidGrid.mins[ i ], cg_solidGrid.maxs[ i ], cells );
+
+			if ( ( cells[ 2 ] - cells[ 0 ] + 1 ) * ( cells[ 3 ] - cells[ 1 ] + 1 ) > SOLID_GRID_MAX_SPAN )
+			{
+				indexed[ i ] = false;
+			}
+		}
+
+		if ( !indexed[ i ] )
+		{
+			cg_solidGrid.unindexed[ cg_solidGrid.numUnindexed++ ] = i;
+			continue;
+		}
+
+		for ( y = cells[ 1 ]; y <= cells[ 3 ]; y++ )
+		{
+			for ( x = cells[ 0 ]; x <= cells[ 2 ]; x++ )
+			{
+				count[ y * cg_solidGrid.width + x ]++;
+			}
+		}
+	}
+
+	cg_solidGrid.start[ 0 ] = 0;
+
+	for ( i = 0; i < numCells; i++ )
+	{
+		cg_solidGrid.start[ i + 1 ] = cg_solidGrid.start[ i ] + count[ i ];
+		count[ i ] = cg_solidGrid.start[ i ];
+	}
+
+	for ( i = 0; i < cg_numSolidEntities; i++ )
+	{
+		if ( !indexed[ i ] )
+		{
+			continue;
+		}
+
+		CG_SolidGridCells( cg_solidGrid.mins[ i ], cg_solidGrid.maxs[ i ], cells );
+
+		for ( y = cells[ 1 ]; y <= cells[ 3 ]; y++ )
+		{
+			for ( x = cells[ 0 ]; x <= cells[ 2 ]; x++ )
+			{
+				cg_solidGrid.items[ count[ y * cg_solidGrid.width + x ]++ ] = i;
+			}
+		}
+	}
+}
+
+/*
+====================
+CG_QuerySolidGrid
+
+Finds the solid entities that may touch the bounds of a trace, in the order
+of the solid list. Returns the number of entities found.
+====================
+*/
+static int CG_QuerySolidGrid( const vec3_t mins, const vec3_t maxs, int *candidates )
+{
+	int cells[ 4 ];
+	int i, x, y, n, num = 0;
+
+	CG_SolidGridCells( mins, maxs, cells );
+
+	if ( ( cells[ 2 ] - cells[ 0 ] + 1 ) * ( cells[ 3 ] - cells[ 1 ] + 1 ) > SOLID_GRID_MAX_QUERY )
+	{
+		cg_traceStats.fallbacks++;
+
+		for ( i = 0; i < cg_numSolidEntities; i++ )
+		{
+			candidates[ i ] = i;
+		}
+
+		return cg_numSolidEntities;
+	}
+
+	cg_solidGrid.stamp++;
+
+	for ( y = cells[ 1 ]; y <= cells[ 3 ]; y++ )
+	{
+		for ( x = cells[ 0 ]; x <= cells[ 2 ]; x++ )
+		{
+			int c = y * cg_solidGrid.width + x;
+
+			for ( n = cg_solidGrid.start[ c ]; n < cg_solidGrid.start[ c + 1 ]; n++ )
+			{
+				i = cg_solidGrid.items[ n ];
+
+				if ( cg_solidGrid.stamps[ i ] == cg_solidGrid.stamp ||
+				     !BoundsIntersect( cg_solidGrid.mins[ i ], cg_solidGrid.maxs[ i ], mins, maxs ) )
+				{
+					continue;
+				}
+
+				cg_solidGrid.stamps[ i ] = cg_solidGrid.stamp;
+				candidates[ num++ ] = i;
+			}
+		}
+	}
+
+	for ( n = 0; n < cg_solidGrid.numUnindexed; n++ )
+	{
+		candidates[ num++ ] = cg_solidGrid.unindexed[ n ];
+	}
+
+	// keep the order of the solid list so ties are resolved as before
+	std::sort( candidates, candidates + num );
+
+	return num;
+}
+
+/*
+====================
+CG_TraceStats
+
+Prints how many entities traces had to look at, with cg_debugTraceStats.
+====================
+*/
+static void CG_TraceStats()
+{
+	if ( !cg_debugTraceStats.integer || cg.time - cg_traceStats.time < 1000 )
+	{
+		return;
+	}
+
+	if ( cg_traceStats.traces )
+	{
+		Log::Notice( "traces: %d, solid entities: %d (%d always tested), candidates per trace: %.2f, "
+		             "tested per trace: %.2f, full scans: %d",
+		             cg_traceStats.traces, cg_numSolidEntities, cg_solidGrid.numUnindexed,
+		             ( float ) cg_traceStats.candidates / cg_traceStats.traces,
+		             ( float ) cg_traceStats.tested / cg_traceStats.traces, cg_traceStats.fallbacks );
+	}
+
+	memset( &cg_traceStats, 0, sizeof( cg_traceStats ) );
+	cg_traceStats.time = cg.time;
+}
+
 /*
 ====================
 CG_BuildSolidList
@@ -100,6 +395,9 @@ void CG_BuildSolidList()
 			continue;
 		}
 	}
+
+	CG_BuildSolidGrid();
+	CG_TraceStats();
 }
 
 /*
@@ -112,7 +410,8 @@ static void CG_ClipMoveToEntities( const vec3_t start, const vec3_t mins,
                                    const vec3_t maxs, const vec3_t end, int skipNumber,
                                    int mask, int skipmask, trace_t *tr, traceType_t collisionType )
 {
-	int           i, x, zd, zu;
+	int           i, n, numCandidates, x, zd, zu;
+	int           candidates[ MAX_ENTITIES_IN_SNAPSHOT ];
 	trace_t       trace;
 	entityState_t *ent;
 	clipHandle_t  cmodel;
@@ -130,17 +429,15 @@ static void CG_ClipMoveToEntities( const vec3_t start, const vec3_t mins,
 	if( maxs )
 		VectorAdd( maxs, tmaxs, tmaxs );
 
-	for ( i = 0; i < cg_numSolidEntities; i++ )
-	{
-		if ( i < cg_numSolidEntities )
-		{
-			cent = cg_solidEntities[ i ];
-		}
-		else
-		{
-			cent = &cg.predictedPlayerEntity;
-		}
+	numCandidates = CG_QuerySolidGrid( tmins, tmaxs, candidates );
 
+	cg_traceStats.traces++;
+	cg_traceStats.candidates += numCandidates;
+
+	for ( n = 0; n < numCandidates; n++ )
+	{
+		i = candidates[ n ];
+		cent = cg_solidEntities[ i ];
 		ent = &cent->currentState;
 
 		if ( ent->number == skipNumber )
@@ -177,11 +474,6 @@ static void CG_ClipMoveToEntities( const vec3_t start, const vec3_t mins,
 			bmins[ 2 ] = -zd;
 			bmaxs[ 2 ] = zu;
 
-			if ( i == cg_numSolidEntities )
-			{
-				BG_ClassBoundingBox( ( ent->misc >> 8 ) & 0xFF, bmins, bmaxs, nullptr, nullptr, nullptr );
-			}
-
 			VectorAdd( cent->lerpOrigin, bmins, bmins );
 			VectorAdd( cent->lerpOrigin, bmaxs, bmaxs );
 
@@ -193,6 +485,8 @@ static void CG_ClipMoveToEntities( const vec3_t start, const vec3_t mins,
 			VectorCopy( vec3_origin, origin );
 		}
 
+		cg_traceStats.tested++;
+
 		switch ( collisionType )
 		{
 		case traceType_t::TT_CAPSULE:
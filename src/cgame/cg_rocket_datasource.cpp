@@ -33,33 +33,241 @@ Maryland 20850 USA.
 */
 
 #include "cg_local.h"
+#include <algorithm>
+#include <unordered_map>
 
-static void AddToServerList( const char *name, const char *label, int clients, int bots, int ping, int maxClients, char *mapName, char *addr, int netSrc )
+/*
+The server browser keeps a model of the servers of each net source. A server
+keeps its slot in rocketInfo.data.servers (its id) for as long as the engine
+lists it, and serverRows holds the ids of the listed servers in table order,
+each listed server keeping its index in there as its row.
+Refreshes upsert servers by address and only feed the rows which actually
+changed into the data source.
+*/
+
+static std::unordered_map<std::string, int> serverIds[ AS_FAVORITES + 1 ];
+
+static uint32_t ServerInfoHash( const char *info, int ping )
 {
-	server_t *node;
+	uint32_t hash = 2166136261u;
 
-	if ( rocketInfo.data.serverCount[ netSrc ] == MAX_SERVERS )
+	for ( const char *p = info; *p; p++ )
 	{
-		return;
+		hash = ( hash ^ ( unsigned char ) *p ) * 16777619u;
 	}
 
-	if ( !*name || !*mapName )
+	return ( hash ^ ( uint32_t ) ping ) * 16777619u;
+}
+
+static void ServerListFreeServer( server_t *server )
+{
+	BG_Free( server->name );
+	BG_Free( server->label );
+	BG_Free( server->addr );
+	BG_Free( server->mapName );
+	BG_Free( server->filterName );
+	memset( server, 0, sizeof( *server ) );
+}
+
+static void ServerListSetFields( server_t *server, const char *info, int ping )
+{
+	char filterName[ MAX_INFO_VALUE ];
+
+	BG_Free( server->name );
+	BG_Free( server->label );
+	BG_Free( server->addr );
+	BG_Free( server->mapName );
+	BG_Free( server->filterName );
+
+	server->name = BG_strdup( Info_ValueForKey( info, "hostname" ) );
+	server->label = BG_strdup( Info_ValueForKey( info, "label" ) );
+	server->addr = BG_strdup( Info_ValueForKey( info, "addr" ) );
+	server->mapName = BG_strdup( Info_ValueForKey( info, "mapname" ) );
+	server->clients = atoi( Info_ValueForKey( info, "clients" ) );
+	server->bots = atoi( Info_ValueForKey( info, "bots" ) );
+	server->maxClients = atoi( Info_ValueForKey( info, "sv_maxclients" ) );
+	server->ping = ping;
+
+	Q_strncpyz( filterName, server->name, sizeof( filterName ) );
+	Color::StripColors( filterName );
+	Q_strlwr( filterName );
+	server->filterName = BG_strdup( filterName );
+}
+
+static int ServerListAllocate( int netSrc )
+{
+	if ( rocketInfo.data.serverCount[ netSrc ] < MAX_SERVERS )
 	{
-		return;
+		return rocketInfo.data.serverCount[ netSrc ]++;
+	}
+
+	for ( int i = 0; i < MAX_SERVERS; ++i )
+	{
+		if ( !rocketInfo.data.servers[ netSrc ][ i ].inUse )
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static int ServerListCompare( int netSrc, int one, int two )
+{
+	const server_t *a = &rocketInfo.data.servers[ netSrc ][ one ];
+	const server_t *b = &rocketInfo.data.servers[ netSrc ][ two ];
+	int cmp = 0;
+
+	switch ( rocketInfo.data.serverSortKey[ netSrc ] )
+	{
+		case SERVERSORT_PING:
+			cmp = a->ping - b->ping;
+			break;
+
+		case SERVERSORT_NAME:
+			cmp = strcmp( a->filterName, b->filterName );
+			break;
+
+		case SERVERSORT_PLAYERS:
+			cmp = a->clients - b->clients;
+			break;
+
+		case SERVERSORT_MAP:
+			cmp = Q_stricmp( a->mapName, b->mapName );
+			break;
+
+		default:
+			break;
+	}
+
+	// break ties by id so that the row order is well defined
+	return cmp ? cmp : one - two;
+}
+
+static bool ServerListShouldList( int netSrc, const server_t *server )
+{
+	return server->inUse && server->ping > 0 &&
+	       strstr( server->filterName, rocketInfo.data.serverFilter[ netSrc ] );
+}
+
+static void ServerListRowData( const server_t *server, char *data )
+{
+	*data = '\0';
+	Info_SetValueForKey( data, "name", server->name, false );
+	Info_SetValueForKey( data, "players", va( "%d", server->clients ), false );
+	Info_SetValueForKey( data, "bots", va( "%d", server->bots ), false );
+	Info_SetValueForKey( data, "ping", va( "%d", server->ping ), false );
+	Info_SetValueForKey( data, "maxClients", va( "%d", server->maxClients ), false );
+	Info_SetValueForKey( data, "addr", server->addr, false );
+	Info_SetValueForKey( data, "label", server->label, false );
+	Info_SetValueForKey( data, "map", server->mapName, false );
+}
+
+static int ServerListFindRow( int netSrc, int id )
+{
+	const server_t *server = &rocketInfo.data.servers[ netSrc ][ id ];
+
+	return server->listed ? server->row : -1;
+}
+
+// Stores the row of the servers listed from row start on, after they moved
+static void ServerListNumberRows( int netSrc, int start )
+{
+	const int *rows = rocketInfo.data.serverRows[ netSrc ];
+
+	for ( int row = start; row < rocketInfo.data.serverRowCount[ netSrc ]; ++row )
+	{
+		rocketInfo.data.servers[ netSrc ][ rows[ row ] ].row = row;
+	}
+}
+
+static void ServerListRemoveRow( int netSrc, int row )
+{
+	int *rows = rocketInfo.data.serverRows[ netSrc ];
+	int *count = &rocketInfo.data.serverRowCount[ netSrc ];
+
+	rocketInfo.data.servers[ netSrc ][ rows[ row ] ].listed = false;
+	memmove( rows + row, rows + row + 1, ( *count - row - 1 ) * sizeof( *rows ) );
+	( *count )--;
+	ServerListNumberRows( netSrc, row );
+
+	Rocket_DSRemoveRow( "server_browser", CG_NetSourceToString( netSrc ), row );
+}
+
+static void ServerListInsertRow( int netSrc, int id )
+{
+	char data[ MAX_INFO_STRING ];
+	int *rows = rocketInfo.data.serverRows[ netSrc ];
+	int *count = &rocketInfo.data.serverRowCount[ netSrc ];
+	int low = 0, high = *count;
+
+	while ( low < high )
+	{
+		int mid = ( low + high ) / 2;
+
+		if ( ServerListCompare( netSrc, rows[ mid ], id ) < 0 )
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
 	}
 
-	node = &rocketInfo.data.servers[ netSrc ][ rocketInfo.data.serverCount[ netSrc ] ];
+	memmove( rows + low + 1, rows + low, ( *count - low ) * sizeof( *rows ) );
+	rows[ low ] = id;
+	( *count )++;
+	ServerListNumberRows( netSrc, low );
 
-	node->name = BG_strdup( name );
-	node->clients = clients;
-	node->bots = bots;
-	node->ping = ping;
-	node->maxClients = maxClients;
-	node->addr = BG_strdup( addr );
-	node->label = BG_strdup( label );
-	node->mapName = BG_strdup( mapName );
+	rocketInfo.data.servers[ netSrc ][ id ].listed = true;
+	ServerListRowData( &rocketInfo.data.servers[ netSrc ][ id ], data );
+	Rocket_DSInsertRow( "server_browser", CG_NetSourceToString( netSrc ), low, data );
+}
+
+// Brings the row of a server in line with its fields: changed in place when it
+// still sorts at the same position, moved, added or removed otherwise.
+static void ServerListUpdateRow( int netSrc, int id )
+{
+	server_t *server = &rocketInfo.data.servers[ netSrc ][ id ];
+	bool shouldList = ServerListShouldList( netSrc, server );
 
-	rocketInfo.data.serverCount[ netSrc ]++;
+	if ( server->listed )
+	{
+		const int *rows = rocketInfo.data.serverRows[ netSrc ];
+		int count = rocketInfo.data.serverRowCount[ netSrc ];
+		int row = ServerListFindRow( netSrc, id );
+
+		if ( shouldList &&
+		     ( row == 0 || ServerListCompare( netSrc, rows[ row - 1 ], id ) < 0 ) &&
+		     ( row == count - 1 || ServerListCompare( netSrc, id, rows[ row + 1 ] ) < 0 ) )
+		{
+			char data[ MAX_INFO_STRING ];
+
+			ServerListRowData( server, data );
+			Rocket_DSChangeRow( "server_browser", CG_NetSourceToString( netSrc ), row, data );
+			return;
+		}
+
+		ServerListRemoveRow( netSrc, row );
+	}
+
+	if ( shouldList )
+	{
+		ServerListInsertRow( netSrc, id );
+	}
+}
+
+static server_t *ServerListSelected( int netSrc )
+{
+	int row = rocketInfo.data.serverIndex[ netSrc ];
+
+	if ( row < 0 || row >= rocketInfo.data.serverRowCount[ netSrc ] )
+	{
+		return nullptr;
+	}
+
+	return &rocketInfo.data.servers[ netSrc ][ rocketInfo.data.serverRows[ netSrc ][ row ] ];
 }
 
 static void CG_Rocket_SetServerListServer( const char *table, int index )
@@ -84,9 +292,9 @@ void CG_Rocket_BuildServerInfo()
 	server_t *server;
 	int netSrc = rocketInfo.currentNetSrc;
 
-	int serverIndex = rocketInfo.data.serverIndex[ netSrc ];
+	server = ServerListSelected( netSrc );
 
-	if ( serverIndex >= rocketInfo.data.serverCount[ netSrc ] || serverIndex < 0 )
+	if ( !server )
 	{
 		return;
 	}
@@ -105,9 +313,6 @@ void CG_Rocket_BuildServerInfo()
 		rocketInfo.data.buildingServerInfo = true;
 	}
 
-	server = &rocketInfo.data.servers[ netSrc ][ serverIndex ];
-
-
 	if ( trap_LAN_ServerStatus( server->addr, serverInfoText, sizeof( serverInfoText ) ) )
 	{
 		int i = 0, score, ping;
@@ -231,7 +436,6 @@ void CG_Rocket_BuildServerInfo()
 
 void CG_Rocket_BuildServerList( const char *args )
 {
-	char data[ MAX_INFO_STRING ] = { 0 };
 	int netSrc = CG_StringToNetSource( args );
 	int i;
 
@@ -250,9 +454,6 @@ void CG_Rocket_BuildServerList( const char *args )
 
 		rocketInfo.data.retrievingServers = true;
 
-		Rocket_DSClearTable( "server_browser", args );
-		CG_Rocket_CleanUpServerList( args );
-
 		trap_LAN_MarkServerVisible( netSrc, -1, true );
 
 		numServers = trap_LAN_GetServerCount( netSrc );
@@ -260,15 +461,22 @@ void CG_Rocket_BuildServerList( const char *args )
 		// Still waiting for a response...
 		if ( numServers == -1 )
 		{
+			CG_Rocket_CleanUpServerList( args );
 			return;
 		}
 
+		for ( i = 0; i < rocketInfo.data.serverCount[ netSrc ]; ++i )
+		{
+			rocketInfo.data.servers[ netSrc ][ i ].seen = false;
+		}
+
 		for ( i = 0; i < numServers; ++i )
 		{
 			char info[ MAX_STRING_CHARS ];
-			int ping, bots, clients, maxClients;
-
-			Com_Memset( &data, 0, sizeof( data ) );
+			std::string addr;
+			server_t *server;
+			uint32_t hash;
+			int ping, id;
 
 			if ( !trap_LAN_ServerIsVisible( netSrc, i ) )
 			{
@@ -277,146 +485,120 @@ void CG_Rocket_BuildServerList( const char *args )
 
 			ping = trap_LAN_GetServerPing( netSrc, i );
 
-			if ( ping >= 0 || !Q_stricmp( args, "favorites" ) )
-			{
-				char addr[ 50 ]; // long enough for IPv6 literal plus port no.
-				char mapname[ 256 ];
-				trap_LAN_GetServerInfo( netSrc, i, info, sizeof( info ) );
-
-				bots = atoi( Info_ValueForKey( info, "bots" ) );
-				clients = atoi( Info_ValueForKey( info, "clients" ) );
-				maxClients = atoi( Info_ValueForKey( info, "sv_maxclients" ) );
-				Q_strncpyz( addr, Info_ValueForKey( info, "addr" ), sizeof( addr ) );
-				Q_strncpyz( mapname, Info_ValueForKey( info, "mapname" ), sizeof( mapname ) );
-				AddToServerList( Info_ValueForKey( info, "hostname" ), Info_ValueForKey( info, "label" ), clients, bots, ping, maxClients, mapname, addr, netSrc );
-			}
-		}
-
-		for ( i = 0; i < rocketInfo.data.serverCount[ netSrc ]; ++i )
-		{
-			if ( rocketInfo.data.servers[ netSrc ][ i ].ping <= 0 )
+			if ( ping < 0 )
 			{
 				continue;
 			}
 
-			Info_SetValueForKey( data, "name", rocketInfo.data.servers[ netSrc ][ i ].name, false );
-			Info_SetValueForKey( data, "players", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].clients ), false );
-			Info_SetValueForKey( data, "bots", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].bots ), false );
-			Info_SetValueForKey( data, "ping", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].ping ), false );
-			Info_SetValueForKey( data, "maxClients", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].maxClients ), false );
-			Info_SetValueForKey( data, "addr", rocketInfo.data.servers[ netSrc ][ i ].addr, false );
-			Info_SetValueForKey( data, "label", rocketInfo.data.servers[ netSrc ][ i ].label, false );
-			Info_SetValueForKey( data, "map", rocketInfo.data.servers[ netSrc ][ i ].mapName, false );
+			trap_LAN_GetServerInfo( netSrc, i, info, sizeof( info ) );
 
-			Rocket_DSAddRow( "server_browser", args, data );
-
-			if ( rocketInfo.data.retrievingServers )
+			if ( !*Info_ValueForKey( info, "hostname" ) || !*Info_ValueForKey( info, "mapname" ) )
 			{
-				rocketInfo.data.retrievingServers = false;
+				continue;
 			}
-		}
-
-	}
 
-	else if ( !Q_stricmp( args, "serverInfo" ) )
-	{
-		CG_Rocket_BuildServerInfo();
-	}
-}
-
-static int ServerListCmpByPing( const void *one, const void *two )
-{
-	server_t* a = ( server_t* ) one;
-	server_t* b = ( server_t* ) two;
-
-	if ( a->ping > b->ping ) return 1;
-
-	if ( b->ping > a->ping ) return -1;
+			addr = Info_ValueForKey( info, "addr" );
+			hash = ServerInfoHash( info, ping );
 
-	if ( a->ping == b->ping )  return 0;
-
-	return 0; // silence compiler
-}
+			auto it = serverIds[ netSrc ].find( addr );
 
-static int ServerListCmpByName( const void* one, const void* two )
-{
-	static char cleanName1[ MAX_STRING_CHARS ] = { 0 };
-	static char cleanName2[ MAX_STRING_CHARS ] = { 0 };
-	server_t* a = ( server_t* ) one;
-	server_t* b = ( server_t* ) two;
+			if ( it != serverIds[ netSrc ].end() )
+			{
+				id = it->second;
+				server = &rocketInfo.data.servers[ netSrc ][ id ];
+				server->seen = true;
 
-	Q_strncpyz( cleanName1, a->name, sizeof( cleanName1 ) );
-	Q_strncpyz( cleanName2, b->name, sizeof( cleanName2 ) );
+				// nothing changed since the last refresh
+				if ( server->infoHash == hash )
+				{
+					continue;
+				}
+			}
+			else
+			{
+				id = ServerListAllocate( netSrc );
 
-	Color::StripColors( cleanName1 );
-	Color::StripColors( cleanName2 );
+				if ( id < 0 )
+				{
+					continue;
+				}
 
-	return Q_stricmp( cleanName1, cleanName2 );
-}
+				serverIds[ netSrc ][ addr ] = id;
+				server = &rocketInfo.data.servers[ netSrc ][ id ];
+				server->inUse = true;
+				server->seen = true;
+			}
 
-static int ServerListCmpByMap( const void* one, const void* two )
-{
-	server_t* a = ( server_t* ) one;
-	server_t* b = ( server_t* ) two;
+			ServerListSetFields( server, info, ping );
+			server->infoHash = hash;
+			ServerListUpdateRow( netSrc, id );
+		}
 
-	return Q_stricmp( a->mapName, b->mapName );
-}
+		// Drop the servers the engine doesn't list anymore
+		for ( i = 0; i < rocketInfo.data.serverCount[ netSrc ]; ++i )
+		{
+			server_t *server = &rocketInfo.data.servers[ netSrc ][ i ];
 
-static int ServerListCmpByPlayers( const void* one, const void* two )
-{
-	server_t* a = ( server_t* ) one;
-	server_t* b = ( server_t* ) two;
+			if ( !server->inUse || server->seen )
+			{
+				continue;
+			}
 
-	if ( a->clients > b->clients ) return 1;
+			if ( server->listed )
+			{
+				ServerListRemoveRow( netSrc, ServerListFindRow( netSrc, i ) );
+			}
 
-	if ( b->clients > a->clients ) return -1;
+			serverIds[ netSrc ].erase( server->addr );
+			ServerListFreeServer( server );
+		}
 
-	if ( a->clients == b->clients )  return 0;
+		if ( rocketInfo.data.serverRowCount[ netSrc ] )
+		{
+			rocketInfo.data.retrievingServers = false;
+		}
+	}
 
-	return 0; // silence compiler
+	else if ( !Q_stricmp( args, "serverInfo" ) )
+	{
+		CG_Rocket_BuildServerInfo();
+	}
 }
 
 static void CG_Rocket_SortServerList( const char *name, const char *sortBy )
 {
-	char data[ MAX_INFO_STRING ] = { 0 };
+	char data[ MAX_INFO_STRING ];
 	int netSrc = CG_StringToNetSource( name );
-	int  i;
+	int *rows = rocketInfo.data.serverRows[ netSrc ];
+	int count = rocketInfo.data.serverRowCount[ netSrc ];
 
 	if ( !Q_stricmp( sortBy, "ping" ) )
 	{
-		qsort( rocketInfo.data.servers[ netSrc ], rocketInfo.data.serverCount[ netSrc ], sizeof( server_t ), &ServerListCmpByPing );
+		rocketInfo.data.serverSortKey[ netSrc ] = SERVERSORT_PING;
 	}
 	else if ( !Q_stricmp( sortBy, "name" ) )
 	{
-		qsort( rocketInfo.data.servers[ netSrc ], rocketInfo.data.serverCount[ netSrc ], sizeof( server_t ), &ServerListCmpByName );
+		rocketInfo.data.serverSortKey[ netSrc ] = SERVERSORT_NAME;
 	}
 	else if ( !Q_stricmp( sortBy, "players" ) )
 	{
-		qsort( rocketInfo.data.servers[ netSrc ], rocketInfo.data.serverCount[ netSrc ], sizeof( server_t ), &ServerListCmpByPlayers );
+		rocketInfo.data.serverSortKey[ netSrc ] = SERVERSORT_PLAYERS;
 	}
 	else if ( !Q_stricmp( sortBy, "map" ) )
 	{
-		qsort( rocketInfo.data.servers[ netSrc ], rocketInfo.data.serverCount[ netSrc ], sizeof( server_t ), &ServerListCmpByMap );
+		rocketInfo.data.serverSortKey[ netSrc ] = SERVERSORT_MAP;
 	}
 
+	std::sort( rows, rows + count, [ netSrc ]( int a, int b ) {
+		return ServerListCompare( netSrc, a, b ) < 0;
+	} );
+	ServerListNumberRows( netSrc, 0 );
+
 	Rocket_DSClearTable( "server_browser", name );
 
-	for ( i = 0; i < rocketInfo.data.serverCount[ netSrc ]; ++i )
+	for ( int i = 0; i < count; ++i )
 	{
-		if ( rocketInfo.data.servers[ netSrc ][ i ].ping <= 0 )
-		{
-			continue;
-		}
-
-		Info_SetValueForKey( data, "name", rocketInfo.data.servers[ netSrc ][ i ].name, false );
-		Info_SetValueForKey( data, "players", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].clients ), false );
-		Info_SetValueForKey( data, "bots", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].bots ), false );
-		Info_SetValueForKey( data, "ping", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].ping ), false );
-		Info_SetValueForKey( data, "maxClients", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].maxClients ), false );
-		Info_SetValueForKey( data, "addr", rocketInfo.data.servers[ netSrc ][ i ].addr, false );
-		Info_SetValueForKey( data, "label", rocketInfo.data.servers[ netSrc ][ i ].label, false );
-		Info_SetValueForKey( data, "map", rocketInfo.data.servers[ netSrc ][ i ].mapName, false );
-
+		ServerListRowData( &rocketInfo.data.servers[ netSrc ][ rows[ i ] ], data );
 		Rocket_DSAddRow( "server_browser", name, data );
 	}
 }
@@ -433,11 +615,19 @@ void CG_Rocket_CleanUpServerList( const char *table )
 		{
 			for ( j = 0; j < rocketInfo.data.serverCount[ i ]; ++j )
 			{
-				BG_Free( rocketInfo.data.servers[ i ][ j ].name );
-				BG_Free( rocketInfo.data.servers[ i ][ j ].label );
-				BG_Free( rocketInfo.data.servers[ i ][ j ].addr );
-				BG_Free( rocketInfo.data.servers[ i ][ j ].mapName );
-				rocketInfo.data.serverCount[ i ] = 0;
+				if ( rocketInfo.data.servers[ i ][ j ].inUse )
+				{
+					ServerListFreeServer( &rocketInfo.data.servers[ i ][ j ] );
+				}
+			}
+
+			rocketInfo.data.serverCount[ i ] = 0;
+			serverIds[ i ].clear();
+
+			if ( rocketInfo.data.serverRowCount[ i ] )
+			{
+				rocketInfo.data.serverRowCount[ i ] = 0;
+				Rocket_DSClearTable( "server_browser", CG_NetSourceToString( i ) );
 			}
 		}
 	}
@@ -449,35 +639,38 @@ static void CG_Rocket_FilterServerList( const char *table, const char *filter )
 	int netSrc = CG_StringToNetSource( str );
 	int i;
 
-	Rocket_DSClearTable( "server_browser", str );
+	Q_strncpyz( rocketInfo.data.serverFilter[ netSrc ], filter, sizeof( rocketInfo.data.serverFilter[ netSrc ] ) );
+	Q_strlwr( rocketInfo.data.serverFilter[ netSrc ] );
 
-	for ( i = 0; i < rocketInfo.data.serverCount[ netSrc ]; ++i )
+	// Remove the rows which don't match anymore...
+	for ( i = rocketInfo.data.serverRowCount[ netSrc ] - 1; i >= 0; --i )
 	{
-		char name[ MAX_INFO_VALUE ];
-
-		Q_strncpyz( name, rocketInfo.data.servers[ netSrc ][ i ].name, sizeof( name ) );
-
-		if ( Q_stristr( Color::StripColors( name ), filter ) )
+		if ( !ServerListShouldList( netSrc, &rocketInfo.data.servers[ netSrc ][ rocketInfo.data.serverRows[ netSrc ][ i ] ] ) )
 		{
-			char data[ MAX_INFO_STRING ] = { 0 };
+			ServerListRemoveRow( netSrc, i );
+		}
+	}
 
-			Info_SetValueForKey( data, "name", rocketInfo.data.servers[ netSrc ][ i ].name, false );
-			Info_SetValueForKey( data, "players", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].clients ), false );
-			Info_SetValueForKey( data, "bots", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].bots ), false );
-			Info_SetValueForKey( data, "ping", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].ping ), false );
-			Info_SetValueForKey( data, "maxClients", va( "%d", rocketInfo.data.servers[ netSrc ][ i ].maxClients ), false );
-			Info_SetValueForKey( data, "addr", rocketInfo.data.servers[ netSrc ][ i ].addr, false );
-			Info_SetValueForKey( data, "label", rocketInfo.data.servers[ netSrc ][ i ].label, false );
+	// ...and add the ones which now do
+	for ( i = 0; i < rocketInfo.data.serverCount[ netSrc ]; ++i )
+	{
+		server_t *server = &rocketInfo.data.servers[ netSrc ][ i ];
 
-			Rocket_DSAddRow( "server_browser", str, data );
+		if ( !server->listed && ServerListShouldList( netSrc, server ) )
+		{
+			ServerListInsertRow( netSrc, i );
 		}
 	}
 }
 
 void CG_Rocket_ExecServerList( const char *table )
 {
-	int netSrc = CG_StringToNetSource( table );
-	trap_SendConsoleCommand( va( "connect %s", rocketInfo.data.servers[ netSrc ][ rocketInfo.data.serverIndex[ netSrc ] ].addr ) );
+	server_t *server = ServerListSelected( CG_StringToNetSource( table ) );
+
+	if ( server )
+	{
+		trap_SendConsoleCommand( va( "connect %s", server->addr ) );
+	}
 }
 
 static bool Parse( const char **p, char **out )
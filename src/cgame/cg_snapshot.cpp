@@ -96,6 +96,8 @@ void CG_SetInitialSnapshot( snapshot_t *snap )
 
 	cg.snap = snap;
 
+	CG_RegisterSnapshotMedia( snap );
+
 	BG_PlayerStateToEntityState( &snap->ps, &cg_entities[ snap->ps.clientNum ].currentState, false );
 
 	// sort out solid entities
@@ -171,6 +173,8 @@ static void CG_TransitionSnapshot()
 	oldFrame = cg.snap;
 	cg.snap = cg.nextSnap;
 
+	CG_RegisterSnapshotMedia( cg.snap );
+
 	// Need to store the previous weapon because BG_PlayerStateToEntityState might change it
 	// so the CG_OnPlayerWeaponChange callback is never called
 	oldWeapon = oldFrame->ps.weapon;
@@ -29,6 +29,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "cg_local.h"
 
+#include <unordered_map>
+
 /*
 =============================================================================
 
@@ -1284,6 +1286,210 @@ static void CG_smoothWJTransitions( playerState_t *ps, const vec3_t in, vec3_t o
 	}
 }
 
+/*
+=================================================================
+
+ZONE WEIGHTS
+
+The weights of the colour grading and reverb zones depend on the distance
+to their brush models, which is expensive to query. They are sampled on the
+corners of a sparse grid, built as the view moves around, and interpolated
+in between. Each corner only keeps the greatest weights.
+
+=================================================================
+*/
+
+#define ZONE_CELL_SIZE    64.0f
+#define ZONE_MAX_CORNERS  65536
+#define ZONE_MAX_ZONES    ( MAX_GRADING_TEXTURES > MAX_REVERB_EFFECTS ? MAX_GRADING_TEXTURES : MAX_REVERB_EFFECTS )
+#define ZONE_CORNER_SLOTS 3
+
+typedef struct
+{
+	int   idx[ ZONE_CORNER_SLOTS ];
+	float weight[ ZONE_CORNER_SLOTS ];
+} zoneCorner_t;
+
+typedef struct
+{
+	// zones the grid is built for, set by the caller before each lookup
+	int       numZones;
+	bool      enabled[ ZONE_MAX_ZONES ];
+
+	bool      builtEnabled[ ZONE_MAX_ZONES ];
+	qhandle_t builtModels[ ZONE_MAX_ZONES ];
+	float     builtDistances[ ZONE_MAX_ZONES ];
+	int       builtFirst;
+
+	std::unordered_map<uint64_t, zoneCorner_t> corners;
+} zoneCache_t;
+
+static zoneCache_t gradingZones;
+static zoneCache_t reverbZones;
+
+/*
+===============
+CG_InsertZoneWeight
+
+Keeps the greatest weights in decreasing order.
+===============
+*/
+static void CG_InsertZoneWeight( int zone, float weight, int *idx, float *weights, int num )
+{
+	int j;
+
+	if ( num <= 0 || weight <= weights[ num - 1 ] )
+	{
+		return;
+	}
+
+	for ( j = num - 2; j >= 0; j-- )
+	{
+		if ( weight <= weights[ j ] )
+		{
+			break;
+		}
+
+		idx[ j + 1 ] = idx[ j ];
+		weights[ j + 1 ] = weights[ j ];
+	}
+
+	idx[ j + 1 ] = zone;
+	weights[ j + 1 ] = weight;
+}
+
+/*
+===============
+CG_ZoneWeightsForPoint
+
+Computes the greatest zone weights at a point.
+===============
+*/
+static void CG_ZoneWeightsForPoint( const zoneCache_t *cache, const vec3_t loc, int first,
+                                    const qhandle_t *models, const float *distances,
+                                    int *idx, float *weights, int num )
+{
+	for ( int i = first; i < cache->numZones; i++ )
+	{
+		if ( !cache->enabled[ i ] )
+		{
+			continue;
+		}
+
+		float dist = trap_CM_DistanceToModel( loc, models[ i ] );
+		float weight = 1.0f - dist / distances[ i ];
+		weight = Q_clamp( weight, 0.0f, 1.0f ); // Maths::clampFraction( weight )
+
+		CG_InsertZoneWeight( i, weight, idx, weights, num );
+	}
+}
+
+/*
+===============
+CG_ZoneCorner
+===============
+*/
+static const zoneCorner_t &CG_ZoneCorner( zoneCache_t *cache, int x, int y, int z,
+                                          const qhandle_t *models, const float *distances )
+{
+	uint64_t key = ( ( uint64_t )( x & 0x1fffff ) << 42 ) |
+	               ( ( uint64_t )( y & 0x1fffff ) << 21 ) |
+	                 ( uint64_t )( z & 0x1fffff );
+	auto it = cache->corners.find( key );
+
+	if ( it != cache->corners.end() )
+	{
+		return it->second;
+	}
+
+	zoneCorner_t corner = {};
+	vec3_t       point;
+
+	point[ 0 ] = x * ZONE_CELL_SIZE;
+	point[ 1 ] = y * ZONE_CELL_SIZE;
+	point[ 2 ] = z * ZONE_CELL_SIZE;
+
+	CG_ZoneWeightsForPoint( cache, point, cache->builtFirst, models, distances,
+	                        corner.idx, corner.weight, ZONE_CORNER_SLOTS );
+
+	return cache->corners.emplace( key, corner ).first->second;
+}
+
+/*
+===============
+CG_ZoneWeights
+
+Gets the greatest zone weights at a point, skipping the zones before first.
+===============
+*/
+static void CG_ZoneWeights( zoneCache_t *cache, const vec3_t loc, int first,
+                            const qhandle_t *models, const float *distances,
+                            int *idx, float *weights, int num )
+{
+	float  accum[ ZONE_MAX_ZONES ];
+	vec3_t cell;
+	int    base[ 3 ];
+	int    i;
+
+	if ( !cg_zoneWeightCache.integer )
+	{
+		CG_ZoneWeightsForPoint( cache, loc, first, models, distances, idx, weights, num );
+		return;
+	}
+
+	// start over when the zones change
+	if ( cache->builtFirst != first || cache->corners.size() >= ZONE_MAX_CORNERS ||
+	     memcmp( cache->builtEnabled, cache->enabled, cache->numZones * sizeof( bool ) ) ||
+	     memcmp( cache->builtModels, models, cache->numZones * sizeof( qhandle_t ) ) ||
+	     memcmp( cache->builtDistances, distances, cache->numZones * sizeof( float ) ) )
+	{
+		cache->corners.clear();
+		cache->builtFirst = first;
+		memcpy( cache->builtEnabled, cache->enabled, cache->numZones * sizeof( bool ) );
+		memcpy( cache->builtModels, models, cache->numZones * sizeof( qhandle_t ) );
+		memcpy( cache->builtDistances, distances, cache->numZones * sizeof( float ) );
+	}
+
+	for ( i = 0; i < 3; i++ )
+	{
+		float f = loc[ i ] / ZONE_CELL_SIZE;
+
+		base[ i ] = floorf( f );
+		cell[ i ] = f - base[ i ];
+	}
+
+	memset( accum, 0, sizeof( accum ) );
+
+	for ( i = 0; i < 8; i++ )
+	{
+		int   dx = i & 1, dy = ( i >> 1 ) & 1, dz = ( i >> 2 ) & 1;
+		float factor = ( dx ? cell[ 0 ] : 1.0f - cell[ 0 ] ) *
+		               ( dy ? cell[ 1 ] : 1.0f - cell[ 1 ] ) *
+		               ( dz ? cell[ 2 ] : 1.0f - cell[ 2 ] );
+
+		if ( factor <= 0.0f )
+		{
+			continue;
+		}
+
+		const zoneCorner_t &corner = CG_ZoneCorner( cache, base[ 0 ] + dx, base[ 1 ] + dy, base[ 2 ] + dz,
+		                                            models, distances );
+
+		for ( int k = 0; k < ZONE_CORNER_SLOTS; k++ )
+		{
+			accum[ corner.idx[ k ] ] += factor * corner.weight[ k ];
+		}
+	}
+
+	for ( i = first; i < cache->numZones; i++ )
+	{
+		if ( accum[ i ] > 0.0f )
+		{
+			CG_InsertZoneWeight( i, accum[ i ], idx, weights, num );
+		}
+	}
+}
+
 /*
 ===============
 CG_CalcColorGradingForPoint
@@ -1294,7 +1500,6 @@ Sets cg.refdef.gradingWeights
 static void CG_CalcColorGradingForPoint( vec3_t loc )
 {
 	int   i, j;
-	float dist, weight;
 	int   selectedIdx[3] = { 0, 0, 0 };
 	float selectedWeight[3] = { 0.0f, 0.0f, 0.0f };
 	float totalWeight = 0.0f;
@@ -1312,38 +1517,16 @@ static void CG_CalcColorGradingForPoint( vec3_t loc )
 		i = 1;
 	}
 
-	for(; i < MAX_GRADING_TEXTURES; i++ )
-	{
-		if( !cgs.gameGradingTextures[i] )
-		{
-			continue;
-		}
-
-		dist = trap_CM_DistanceToModel( loc, cgs.gameGradingModels[i] );
-		weight = 1.0f - dist / cgs.gameGradingDistances[i];
-		weight = Q_clamp( weight, 0.0f, 1.0f ); // Maths::clampFraction( weight )
+	gradingZones.numZones = MAX_GRADING_TEXTURES;
 
-		// search 3 greatest weights
-		if( weight <= selectedWeight[2] )
-		{
-			continue;
-		}
-
-		for( j = 1; j >= 0; j-- )
-		{
-			if( weight <= selectedWeight[j] )
-			{
-				break;
-			}
-
-			selectedIdx[j+1] = selectedIdx[j];
-			selectedWeight[j+1] = selectedWeight[j];
-		}
-
-		selectedIdx[j+1] = i;
-		selectedWeight[j+1] = weight;
+	for ( j = 0; j < MAX_GRADING_TEXTURES; j++ )
+	{
+		gradingZones.enabled[ j ] = cgs.gameGradingTextures[ j ] != 0;
 	}
 
+	CG_ZoneWeights( &gradingZones, loc, i, cgs.gameGradingModels, cgs.gameGradingDistances,
+	                selectedIdx + i, selectedWeight + i, 3 - i );
+
 	i = 0;
 
 	if( haveGlobal )
@@ -1488,7 +1671,6 @@ CG_AddReverbEffects
 static void CG_AddReverbEffects( vec3_t loc )
 {
 	int   i, j;
-	float dist, weight;
 	int   selectedIdx[3] = { 0, 0, 0 };
 	float selectedWeight[3] = { 0.0f, 0.0f, 0.0f };
 	float totalWeight = 0.0f;
@@ -1505,38 +1687,16 @@ static void CG_AddReverbEffects( vec3_t loc )
 		i = 1;
 	}
 
-	for(; i < MAX_REVERB_EFFECTS; i++ )
-	{
-		if( !cgs.gameReverbEffects[i][0] )
-		{
-			continue;
-		}
-
-		dist = trap_CM_DistanceToModel( loc, cgs.gameReverbModels[i] );
-		weight = 1.0f - dist / cgs.gameReverbDistances[i];
-		weight = Q_clamp( weight, 0.0f, 1.0f ); // Maths::clampFraction( weight )
+	reverbZones.numZones = MAX_REVERB_EFFECTS;
 
-		// search 3 greatest weights
-		if( weight <= selectedWeight[2] )
-		{
-			continue;
-		}
-
-		for( j = 1; j >= 0; j-- )
-		{
-			if( weight <= selectedWeight[j] )
-			{
-				break;
-			}
-
-			selectedIdx[j+1] = selectedIdx[j];
-			selectedWeight[j+1] = selectedWeight[j];
-		}
-
-		selectedIdx[j+1] = i;
-		selectedWeight[j+1] = weight;
+	for ( j = 0; j < MAX_REVERB_EFFECTS; j++ )
+	{
+		reverbZones.enabled[ j ] = cgs.gameReverbEffects[ j ][ 0 ] != '\0';
 	}
 
+	CG_ZoneWeights( &reverbZones, loc, i, cgs.gameReverbModels, cgs.gameReverbDistances,
+	                selectedIdx + i, selectedWeight + i, 3 - i );
+
 	i = haveGlobal ? 1 : 0;
 
 	for(; i < 3; i++ )
@@ -1900,6 +2060,9 @@ void CG_DrawActiveFrame( int serverTime, bool demoPlayback )
 	// update cvars (needs valid unlockables data)
 	CG_UpdateCvars();
 
+	// register the media of the team (needs valid unlockables data)
+	CG_UpdateLazyMedia();
+
 	// decide on third person view
 	cg.renderingThirdPerson = ( cg_thirdPerson.integer || ( cg.snap->ps.stats[ STAT_HEALTH ] <= 0 ) ||
 	                            ( cg.chaseFollow && cg.snap->ps.pm_flags & PMF_FOLLOW ) );
@@ -1243,11 +1243,18 @@ void CG_InitWeapons()
 
 	Com_Memset( cg_weapons, 0, sizeof( cg_weapons ) );
 
-	for ( i = WP_NONE + 1; i < WP_NUM_WEAPONS; i++ )
+	// registered when needed, see CG_UpdateLazyMedia
+	for ( i = WP_NONE + 1; i < WP_NUM_WEAPONS && !cgs.lazyMedia; i++ )
 	{
 		CG_RegisterWeapon( i );
 	}
 
+	// buildables fire at any time, their weapons can't wait either
+	for ( i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++ )
+	{
+		CG_RegisterWeaponMedia( BG_Buildable( i )->weapon );
+	}
+
 	cgs.media.level2ZapTS = CG_RegisterTrailSystem( "models/weapons/lev2zap/lightning" );
 }
 
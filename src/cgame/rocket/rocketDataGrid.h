@@ -69,6 +69,12 @@ public:
 		NotifyRowAdd( table, data[ table ].size() - 1, 1 );
 	}
 
+	void InsertRow( const char *table, const int row, const char *dataIn )
+	{
+		data[ table ].insert( data[ table ].begin() + row, dataIn );
+		NotifyRowAdd( table, row, 1 );
+	}
+
 	void ChangeRow( const char *table, const int row, const char *dataIn )
 	{
 		data[ table ][ row ] = dataIn;
@@ -77,7 +83,7 @@ public:
 
 	void RemoveRow( const char *table, const int row )
 	{
-		data[ table ].erase( data[ table ].begin() + row - 1 );
+		data[ table ].erase( data[ table ].begin() + row );
 		NotifyRowRemove( table, row, 1 );
 	}
 
@@ -46,7 +46,7 @@ Maryland 20850 USA.
 class RocketDataSource : public Rocket::Core::Element, public Rocket::Controls::DataSourceListener
 {
 public:
-	RocketDataSource( const Rocket::Core::String &tag ) : Rocket::Core::Element( tag ), dirty_query( false ), dirty_layout( false ), init( false ), radius( 10 ), formatter( nullptr ), data_source( nullptr )
+	RocketDataSource( const Rocket::Core::String &tag ) : Rocket::Core::Element( tag ), dirty_query( false ), dirty_rows( false ), dirty_layout( false ), init( false ), first_stale( -1 ), radius( 10 ), formatter( nullptr ), data_source( nullptr )
 	{
 	}
 
@@ -87,32 +87,89 @@ public:
 		}
 	}
 
-	void OnRowAdd( Rocket::Controls::DataSource*, const Rocket::Core::String&, int, int )
+	void OnRowAdd( Rocket::Controls::DataSource*, const Rocket::Core::String &table, int first_row_added, int num_rows_added )
 	{
-		dirty_query = true;
+		if ( table != data_table || dirty_query || dirty_rows )
+		{
+			return;
+		}
+
+		if ( first_row_added < 0 || first_row_added > ( int ) rows.size() )
+		{
+			dirty_rows = true;
+			return;
+		}
+
+		rows.insert( rows.begin() + first_row_added, num_rows_added, Row() );
+		MarkStale( first_row_added );
 	}
 
-	void OnRowChange( Rocket::Controls::DataSource*, const Rocket::Core::String&, int, int )
+	void OnRowChange( Rocket::Controls::DataSource*, const Rocket::Core::String &table, int first_row_changed, int num_rows_changed )
 	{
-		dirty_query = true;
+		if ( table != data_table || dirty_query || dirty_rows )
+		{
+			return;
+		}
+
+		if ( first_row_changed < 0 || first_row_changed + num_rows_changed > ( int ) rows.size() )
+		{
+			dirty_rows = true;
+			return;
+		}
+
+		for ( int i = first_row_changed; i < first_row_changed + num_rows_changed; ++i )
+		{
+			rows[ i ].stale = true;
+		}
+
+		MarkStale( first_row_changed );
 	}
 
-	void OnRowChange( Rocket::Controls::DataSource*, const Rocket::Core::String& )
+	void OnRowChange( Rocket::Controls::DataSource*, const Rocket::Core::String &table )
 	{
-		dirty_query = true;
+		if ( table == data_table )
+		{
+			dirty_rows = true;
+		}
 	}
 
-	void OnRowRemove( Rocket::Controls::DataSource*, const Rocket::Core::String&, int, int )
+	void OnRowRemove( Rocket::Controls::DataSource*, const Rocket::Core::String &table, int first_row_removed, int num_rows_removed )
 	{
-		dirty_query = true;
-	}
+		if ( table != data_table || dirty_query || dirty_rows )
+		{
+			return;
+		}
 
+		if ( first_row_removed < 0 || first_row_removed + num_rows_removed > ( int ) rows.size() )
+		{
+			dirty_rows = true;
+			return;
+		}
+
+		// the elements stay in the document until the next update
+		for ( int i = first_row_removed; i < first_row_removed + num_rows_removed; ++i )
+		{
+			orphans.insert( orphans.end(), rows[ i ].nodes.begin(), rows[ i ].nodes.end() );
+		}
+
+		rows.erase( rows.begin() + first_row_removed, rows.begin() + first_row_removed + num_rows_removed );
+		MarkStale( first_row_removed );
+	}
 
 	void OnUpdate()
 	{
+		for ( size_t i = 0; i < orphans.size(); ++i )
+		{
+			RemoveChild( orphans[ i ] );
+		}
+
+		orphans.clear();
+
 		if ( dirty_query )
 		{
 			dirty_query = false;
+			dirty_rows = false;
+			first_stale = -1;
 
 			while ( HasChildNodes() )
 			{
@@ -120,44 +177,18 @@ public:
 				RemoveChild( GetFirstChild() );
 			}
 
-			Rocket::Controls::DataQuery query( data_source, data_table, csvFields, 0, -1 );
-			int index = 0;
-
-			while ( query.NextRow() )
-			{
-				Rocket::Core::StringList raw_data;
-				Rocket::Core::String out;
-
-				for ( size_t i = 0; i < fields.size(); ++i )
-				{
-					raw_data.push_back( query.Get<Rocket::Core::String>( fields[ i ], "" ) );
-				}
-
-				raw_data.push_back( va( "%d", index++ ) );
-
-
-				if ( formatter )
-				{
-
-					formatter->FormatData( out, raw_data );
-
-				}
-
-				else
-				{
-					for ( size_t i = 0; i < raw_data.size(); ++i )
-					{
-						if ( i > 0 )
-						{
-							out.Append( "," );
-						}
-
-						out.Append( raw_data[ i ] );
-					}
-				}
-
-				Rocket::Core::Factory::InstanceElementText( this, out );
-			}
+			rows.clear();
+			SyncRows();
+		}
+		else if ( dirty_rows )
+		{
+			dirty_rows = false;
+			first_stale = -1;
+			SyncRows();
+		}
+		else if ( first_stale >= 0 )
+		{
+			UpdateStaleRows();
 		}
 	}
 
@@ -243,6 +274,209 @@ protected:
 
 private:
 
+	// The formatted RML of a row and the child elements it was instanced to.
+	// A row whose RML depends on its index has to be re-formatted when it moves.
+	struct Row
+	{
+		Row() : stale( true ), indexed( false ), index( -1 ) { }
+
+		Rocket::Core::String rml;
+		std::vector<Rocket::Core::Element*> nodes;
+		bool stale;
+		bool indexed;
+		int index;
+	};
+
+	void MarkStale( int row )
+	{
+		if ( first_stale < 0 || row < first_stale )
+		{
+			first_stale = row;
+		}
+	}
+
+	void FormatRow( Rocket::Controls::DataQuery &query, int index, Rocket::Core::String &out )
+	{
+		Rocket::Core::StringList raw_data;
+
+		for ( size_t i = 0; i < fields.size(); ++i )
+		{
+			raw_data.push_back( query.Get<Rocket::Core::String>( fields[ i ], "" ) );
+		}
+
+		raw_data.push_back( va( "%d", index ) );
+
+
+		if ( formatter )
+		{
+
+			formatter->FormatData( out, raw_data );
+
+		}
+
+		else
+		{
+			for ( size_t i = 0; i < raw_data.size(); ++i )
+			{
+				if ( i > 0 )
+				{
+					out.Append( "," );
+				}
+
+				out.Append( raw_data[ i ] );
+			}
+		}
+	}
+
+	// Format the current row of the query into the row at index, and find out
+	// whether the output depends on the index by formatting it for the next one.
+	bool FormatRowAt( Rocket::Controls::DataQuery &query, int index )
+	{
+		Row &row = rows[ index ];
+		Rocket::Core::String out, shifted;
+
+		FormatRow( query, index, out );
+
+		if ( formatter )
+		{
+			FormatRow( query, index + 1, shifted );
+			row.indexed = out != shifted;
+		}
+		else
+		{
+			row.indexed = true;
+		}
+
+		row.index = index;
+		row.stale = false;
+
+		if ( out == row.rml )
+		{
+			return false;
+		}
+
+		row.rml = out;
+		return true;
+	}
+
+	// The element the nodes of a row go before: the first one of the next row
+	// that has any, or none at the end.
+	Rocket::Core::Element *NextRowNode( int row ) const
+	{
+		for ( size_t i = row + 1; i < rows.size(); ++i )
+		{
+			if ( !rows[ i ].nodes.empty() )
+			{
+				return rows[ i ].nodes.front();
+			}
+		}
+
+		return nullptr;
+	}
+
+	// Instance the row's RML in a detached element, then move the result in place
+	// of its old elements so that neighbouring rows (and their focus and scroll
+	// state) are left alone.
+	void InstanceRowNodes( int index )
+	{
+		Row &row = rows[ index ];
+		Rocket::Core::Element *adjacent = row.nodes.empty() ? NextRowNode( index ) : row.nodes.front();
+		Rocket::Core::Element *scratch = Rocket::Core::Factory::InstanceElement( nullptr, "*", "div", Rocket::Core::XMLAttributes() );
+		std::vector<Rocket::Core::Element*> nodes;
+
+		Rocket::Core::Factory::InstanceElementText( scratch, row.rml );
+
+		while ( scratch->HasChildNodes() )
+		{
+			Rocket::Core::Element *child = scratch->GetFirstChild();
+
+			nodes.push_back( child );
+
+			if ( adjacent )
+			{
+				InsertBefore( child, adjacent );
+			}
+			else
+			{
+				AppendChild( child );
+			}
+		}
+
+		scratch->RemoveReference();
+
+		for ( size_t i = 0; i < row.nodes.size(); ++i )
+		{
+			RemoveChild( row.nodes[ i ] );
+		}
+
+		row.nodes.swap( nodes );
+	}
+
+	// Re-format every row of the table and re-instance only those whose output
+	// actually changed.
+	void SyncRows()
+	{
+		Rocket::Controls::DataQuery query( data_source, data_table, csvFields, 0, -1 );
+		int index = 0;
+
+		while ( query.NextRow() )
+		{
+			if ( index >= ( int ) rows.size() )
+			{
+				rows.push_back( Row() );
+			}
+
+			if ( FormatRowAt( query, index ) )
+			{
+				InstanceRowNodes( index );
+			}
+
+			index++;
+		}
+
+		while ( ( int ) rows.size() > index )
+		{
+			for ( size_t i = 0; i < rows.back().nodes.size(); ++i )
+			{
+				RemoveChild( rows.back().nodes[ i ] );
+			}
+
+			rows.pop_back();
+		}
+	}
+
+	// Re-format the rows that were added or changed since the last update, and
+	// those that moved if their output depends on their index. Going from the
+	// last one back, the rows after each are already in place.
+	void UpdateStaleRows()
+	{
+		for ( int index = rows.size() - 1; index >= first_stale; --index )
+		{
+			Row &row = rows[ index ];
+
+			if ( !row.stale && ( !row.indexed || row.index == index ) )
+			{
+				continue;
+			}
+
+			Rocket::Controls::DataQuery query( data_source, data_table, csvFields, index, 1 );
+
+			if ( !query.NextRow() )
+			{
+				// the table is not what the notifications said, start over
+				dirty_rows = true;
+				break;
+			}
+
+			if ( FormatRowAt( query, index ) )
+			{
+				InstanceRowNodes( index );
+			}
+		}
+
+		first_stale = -1;
+	}
+
 	void AddCancelbutton()
 	{
 		init = true;
@@ -251,8 +485,10 @@ private:
 	}
 
 	bool dirty_query;
+	bool dirty_rows;
 	bool dirty_layout;
 	bool init;
+	int first_stale; // lowest row added, changed or moved since the last update
 	float radius;
 	Rocket::Controls::DataFormatter *formatter;
 	Rocket::Controls::DataSource *data_source;
@@ -260,6 +496,8 @@ private:
 	Rocket::Core::String data_table;
 	Rocket::Core::String csvFields;
 	Rocket::Core::StringList fields;
+	std::vector<Row> rows;
+	std::vector<Rocket::Core::Element*> orphans; // elements of removed rows
 	Rocket::Core::Vector2f dimensions;
 };
 
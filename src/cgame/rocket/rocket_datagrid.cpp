@@ -74,6 +74,19 @@ void Rocket_DSAddRow( const char *name, const char *table, const char *data )
 	ds->AddRow( table, data );
 }
 
+void Rocket_DSInsertRow( const char *name, const char *table, const int row, const char *data )
+{
+	RocketDataGrid *ds = FindDataSource( name );
+
+	if ( !ds )
+	{
+		Log::Warn( "Rocket_DSInsertRow: data source %s does not exist.\n", name );
+		return;
+	}
+
+	ds->InsertRow( table, row, data );
+}
+
 void Rocket_DSChangeRow( const char *name, const char *table, const int row, const char *data )
 {
 	RocketDataGrid *ds = FindDataSource( name );
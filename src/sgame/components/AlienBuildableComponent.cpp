@@ -27,7 +27,9 @@ void AlienBuildableComponent::Think(int timeDelta) {
 	float creepSize = (float)BG_Buildable((buildable_t)entity.oldEnt->s.modelindex)->creepSize;
 
 	// Slow close humans.
-	ForEntities<HumanClassComponent>([&] (Entity& other, HumanClassComponent& humanClassComponent) {
+	G_ForThreatsInRange(entity.oldEnt->s.origin, creepSize, TEAM_ALIENS, [&] (Entity& other) {
+		if (!other.Get<HumanClassComponent>()) return;
+
 		// TODO: Add LocationComponent.
 		if (G_Distance(entity.oldEnt, other.oldEnt) > creepSize) return;
 
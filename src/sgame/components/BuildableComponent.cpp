@@ -10,6 +10,12 @@ BuildableComponent::BuildableComponent(Entity& entity, HealthComponent& r_Health
 
 	// TODO: Make power state a member variable.
 	entity.oldEnt->powered = true;
+
+	G_InvalidateBuildablePowerStates();
+}
+
+BuildableComponent::~BuildableComponent() {
+	G_InvalidateBuildablePowerStates();
 }
 
 void BuildableComponent::HandlePrepareNetCode() {
@@ -51,6 +57,9 @@ void BuildableComponent::HandleDie(gentity_t* killer, meansOfDeath_t meansOfDeat
 
 	TeamComponent::team_t team = GetTeamComponent().Team();
 
+	// Dead buildables no longer count towards the deficit.
+	G_InvalidateBuildablePowerStates();
+
 	// TODO: Move animation code to BuildableComponent.
 	G_SetBuildableAnim(entity.oldEnt, Powered() ? BANIM_DESTROY : BANIM_DESTROY_UNPOWERED, true);
 	G_SetIdleBuildableAnim(entity.oldEnt, BANIM_DESTROYED);
@@ -98,6 +107,7 @@ void BuildableComponent::Think(int timeDelta) {
 				if (entity.oldEnt->creationTime + constructionTime < level.time) {
 					// Finish construction.
 					state = CONSTRUCTED;
+					G_InvalidateBuildablePowerStates();
 
 					// Award momentum.
 					G_AddMomentumForBuilding(entity.oldEnt);
@@ -157,6 +167,7 @@ void BuildableComponent::SetPowerState(bool powered) {
 	bool wasPowered = entity.oldEnt->powered;
 
 	entity.oldEnt->powered = powered;
+	G_InvalidateBuildablePowerStates();
 
 	if (powered && !wasPowered) {
 		G_SetBuildableAnim(entity.oldEnt, BANIM_POWERUP, false);
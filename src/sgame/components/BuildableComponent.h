@@ -45,10 +45,12 @@ class BuildableComponent: public BuildableComponentBase {
 
 		// ///////////////////// //
 
+		~BuildableComponent();
+
 		void Think(int timeDelta);
 
 		lifecycle_t GetState() { return state; }
-		void SetState(lifecycle_t state) { this->state = state; }
+		void SetState(lifecycle_t state) { this->state = state; G_InvalidateBuildablePowerStates(); }
 
 		/**
 		 * @return Whether the buildable is currently marked for deconstruction.
@@ -60,9 +62,11 @@ class BuildableComponent: public BuildableComponentBase {
 		 */
 		int  GetMarkTime() const { return marked ? markTime : 0; }
 
-		void SetDeconstructionMark() { marked = true; markTime = level.time; }
-		void ClearDeconstructionMark() { marked = false; }
-		void ToggleDeconstructionMark() { marked = !marked; if (marked) markTime = level.time; }
+		void SetDeconstructionMark() { marked = true; markTime = level.time; G_InvalidateBuildablePowerStates(); }
+		void ClearDeconstructionMark() { marked = false; G_InvalidateBuildablePowerStates(); }
+		void ToggleDeconstructionMark() {
+			marked = !marked; if (marked) markTime = level.time; G_InvalidateBuildablePowerStates();
+		}
 
 		/**
 		 * @brief Change the buildable's power state.
@@ -171,6 +171,8 @@ Util::optional<Vec3> direction, int flags, meansOfDeath_t meansOfDeath) {
 	// Do the damage.
 	health -= take;
 
+	G_EventLogDamage(entity.oldEnt, source, take, meansOfDeath);
+
 	// Update team overlay info.
 	if (client) client->pers.infoChangeTime = level.time;
 
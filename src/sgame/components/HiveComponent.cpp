@@ -50,7 +50,7 @@ void HiveComponent::Think(int timeDelta) {
 Entity* HiveComponent::FindTarget() {
 	Entity* target = nullptr;
 
-	ForEntities<HumanClassComponent>([&](Entity& candidate, HumanClassComponent& humanClassComponent) {
+	G_ForThreatsInRange(entity.oldEnt->s.origin, SENSE_RANGE, TEAM_ALIENS, [&](Entity& candidate) {
 		// Check if target is valid and in sense range.
 		if (!TargetValid(candidate, true)) return;
 
@@ -24,6 +24,8 @@ along with Unvanquished Source Code.  If not, see <http://www.gnu.org/licenses/>
 
 #include "IgnitableComponent.h"
 
+#include <chrono>
+
 static Log::Logger fireLogger("sgame.fire");
 
 const float IgnitableComponent::SELF_DAMAGE             = 12.5f;
@@ -38,6 +40,50 @@ const float IgnitableComponent::SPREAD_RADIUS           = 120.0f;
 static_assert(IgnitableComponent::BASE_AVERAGE_BURN_TIME > IgnitableComponent::MIN_BURN_TIME,
               "Average burn time needs to be greater than minimum burn time.");
 
+/**
+ * @brief Ignitables sorted into cubes of the neighbour radius, so that the neighbours of one are
+ *        in the 27 cubes around it.
+ *
+ * Ignitables hardly ever move. When one is created, removed or moved, only its cell and the
+ * neighbour lists of the ignitables in range of it are updated.
+ */
+static struct {
+	bool pending = false; /**< An ignitable was created since the last update. */
+	int  checkTime = -1;
+	std::vector<IgnitableComponent*> all;
+	std::unordered_map<int64_t, std::vector<Entity*>> cells;
+} ignitableGrid;
+
+/** State of the fire benchmark, see G_FireBenchmark_f. */
+static struct {
+	bool running = false;
+	int  duration;
+	int  ignitables;
+	int  thinks;
+	int  gridChanges;
+	std::chrono::steady_clock::duration thinkTime;
+	std::chrono::steady_clock::duration gridTime;
+} fireBenchmark;
+
+/** Covers both the spread and the extra burn time radius. */
+static float NeighbourRadius() {
+	return std::max(IgnitableComponent::EXTRA_BURN_TIME_RADIUS, IgnitableComponent::SPREAD_RADIUS);
+}
+
+static int64_t IgnitableCell(const vec3_t origin, int dx, int dy, int dz) {
+	float size = NeighbourRadius();
+	int64_t x = (int64_t)BG_GridCell(origin[0], 0.0f, size) + dx;
+	int64_t y = (int64_t)BG_GridCell(origin[1], 0.0f, size) + dy;
+	int64_t z = (int64_t)BG_GridCell(origin[2], 0.0f, size) + dz;
+
+	return ((x & 0x1fffff) << 42) | ((y & 0x1fffff) << 21) | (z & 0x1fffff);
+}
+
+/** Neighbour lists keep the order of ForEntities, the random rolls depend on it. */
+static bool EntityNumberOrder(Entity* a, Entity* b) {
+	return a->oldEnt->s.number < b->oldEnt->s.number;
+}
+
 IgnitableComponent::IgnitableComponent(Entity& entity, bool alwaysOnFire, ThinkingComponent& r_ThinkingComponent)
 	: IgnitableComponentBase(entity, alwaysOnFire, r_ThinkingComponent)
 	, onFire(alwaysOnFire)
@@ -45,12 +91,121 @@ IgnitableComponent::IgnitableComponent(Entity& entity, bool alwaysOnFire, Thinki
 	, immuneUntil(0)
 	, spreadAt(INT_MAX)
 	, fireStarter(nullptr)
+	, inGrid(false)
+	, gridCell(0)
 	, randomGenerator(rand()) // TODO: Have one PRNG for all of sgame.
 	, normalDistribution(0.0f, (float)BASE_AVERAGE_BURN_TIME) {
 	REGISTER_THINKER(DamageSelf, ThinkingComponent::SCHEDULER_AVERAGE, 100);
 	REGISTER_THINKER(DamageArea, ThinkingComponent::SCHEDULER_AVERAGE, 100);
 	REGISTER_THINKER(ConsiderStop, ThinkingComponent::SCHEDULER_AVERAGE, 500);
 	REGISTER_THINKER(ConsiderSpread, ThinkingComponent::SCHEDULER_AVERAGE, 500);
+
+	VectorClear(gridOrigin);
+
+	// The origin is not set yet, add the entity on the next lookup.
+	ignitableGrid.all.push_back(this);
+	ignitableGrid.pending = true;
+}
+
+IgnitableComponent::~IgnitableComponent() {
+	if (inGrid) RemoveFromGrid();
+
+	auto it = std::find(ignitableGrid.all.begin(), ignitableGrid.all.end(), this);
+	*it = ignitableGrid.all.back();
+	ignitableGrid.all.pop_back();
+}
+
+void IgnitableComponent::AddToGrid() {
+	auto start = std::chrono::steady_clock::now();
+
+	VectorCopy(entity.oldEnt->s.origin, gridOrigin);
+	gridCell = IgnitableCell(gridOrigin, 0, 0, 0);
+
+	for (int dx = -1; dx <= 1; dx++) {
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dz = -1; dz <= 1; dz++) {
+				auto cell = ignitableGrid.cells.find(IgnitableCell(gridOrigin, dx, dy, dz));
+
+				if (cell == ignitableGrid.cells.end()) continue;
+
+				for (Entity* other : cell->second) {
+					IgnitableComponent& ignitable = *other->Get<IgnitableComponent>();
+
+					if (Distance(ignitable.gridOrigin, gridOrigin) > NeighbourRadius()) continue;
+
+					neighbours.push_back(other);
+					ignitable.neighbours.insert(std::lower_bound(ignitable.neighbours.begin(),
+						ignitable.neighbours.end(), &entity, EntityNumberOrder), &entity);
+				}
+			}
+		}
+	}
+
+	std::sort(neighbours.begin(), neighbours.end(), EntityNumberOrder);
+
+	ignitableGrid.cells[gridCell].push_back(&entity);
+	inGrid = true;
+
+	if (fireBenchmark.running) {
+		fireBenchmark.gridChanges++;
+		fireBenchmark.gridTime += std::chrono::steady_clock::now() - start;
+	}
+}
+
+void IgnitableComponent::RemoveFromGrid() {
+	auto start = std::chrono::steady_clock::now();
+	auto cell = ignitableGrid.cells.find(gridCell);
+	std::vector<Entity*>& members = cell->second;
+
+	members.erase(std::find(members.begin(), members.end(), &entity));
+
+	if (members.empty()) ignitableGrid.cells.erase(cell);
+
+	for (Entity* other : neighbours) {
+		std::vector<Entity*>& otherNeighbours = other->Get<IgnitableComponent>()->neighbours;
+
+		otherNeighbours.erase(std::find(otherNeighbours.begin(), otherNeighbours.end(), &entity));
+	}
+
+	neighbours.clear();
+	inGrid = false;
+
+	if (fireBenchmark.running) {
+		fireBenchmark.gridChanges++;
+		fireBenchmark.gridTime += std::chrono::steady_clock::now() - start;
+	}
+}
+
+void IgnitableComponent::UpdateGrid() {
+	// Look for moved ignitables once per frame, and for created ones on the next lookup.
+	if (!ignitableGrid.pending && ignitableGrid.checkTime == level.time) return;
+
+	for (IgnitableComponent* ignitable : ignitableGrid.all) {
+		if (ignitable->inGrid) {
+			if (VectorCompare(ignitable->entity.oldEnt->s.origin, ignitable->gridOrigin)) continue;
+
+			ignitable->RemoveFromGrid();
+		}
+
+		ignitable->AddToGrid();
+	}
+
+	ignitableGrid.pending = false;
+	ignitableGrid.checkTime = level.time;
+}
+
+/** Accounts a walk over the neighbours to the fire benchmark. */
+static void FireBenchmarkThink(std::chrono::steady_clock::time_point start) {
+	if (!fireBenchmark.running) return;
+
+	fireBenchmark.thinks++;
+	fireBenchmark.thinkTime += std::chrono::steady_clock::now() - start;
+}
+
+const std::vector<Entity*>& IgnitableComponent::Neighbours() {
+	UpdateGrid();
+
+	return neighbours;
 }
 
 void IgnitableComponent::HandlePrepareNetCode() {
@@ -162,22 +317,26 @@ void IgnitableComponent::ConsiderStop(int timeDelta) {
 	}
 
 	float averagePostMinBurnTime = BASE_AVERAGE_BURN_TIME - MIN_BURN_TIME;
+	auto start = std::chrono::steady_clock::now();
 
 	// Increase average burn time dynamically for burning entities in range.
-	ForEntities<IgnitableComponent>([&](Entity &other, IgnitableComponent &ignitable){
-		if (&other == &entity) return;
-		if (!ignitable.onFire) return;
+	for (Entity* other : Neighbours()) {
+		IgnitableComponent& ignitable = *other->Get<IgnitableComponent>();
+
+		if (!ignitable.onFire) continue;
 
 		// TODO: Use LocationComponent.
-		float distance = G_Distance(other.oldEnt, entity.oldEnt);
+		float distance = G_Distance(other->oldEnt, entity.oldEnt);
 
-		if (distance > EXTRA_BURN_TIME_RADIUS) return;
+		if (distance > EXTRA_BURN_TIME_RADIUS) continue;
 
 		float distanceFrac = distance / EXTRA_BURN_TIME_RADIUS;
 		float distanceMod  = 1.0f - distanceFrac;
 
 		averagePostMinBurnTime += EXTRA_AVERAGE_BURN_TIME * distanceMod;
-	});
+	}
+
+	FireBenchmarkThink(start);
 
 	// The burn stop chance follows an exponential distribution.
 	float lambda = 1.0f / averagePostMinBurnTime;
@@ -204,29 +363,138 @@ void IgnitableComponent::ConsiderSpread(int timeDelta) {
 
 	fireLogger.Notice("Trying to spread.");
 
-	ForEntities<IgnitableComponent>([&](Entity &other, IgnitableComponent &ignitable){
-		if (&other == &entity) return;
+	auto start = std::chrono::steady_clock::now();
+
+	// Igniting neighbours doesn't change the grid, so the list stays valid while spreading.
+	for (Entity* other : Neighbours()) {
+		IgnitableComponent& ignitable = *other->Get<IgnitableComponent>();
 
 		// Don't re-ignite.
-		if (ignitable.onFire) return;
+		if (ignitable.onFire) continue;
 
 		// TODO: Use LocationComponent.
-		float distance = G_Distance(other.oldEnt, entity.oldEnt);
+		float distance = G_Distance(other->oldEnt, entity.oldEnt);
 
-		if (distance > SPREAD_RADIUS) return;
+		if (distance > SPREAD_RADIUS) continue;
 
 		float distanceFrac = distance / SPREAD_RADIUS;
 		float distanceMod  = 1.0f - distanceFrac;
 		float spreadChance = distanceMod;
 
 		if (random() < spreadChance) {
-			if (G_LineOfSight(entity.oldEnt, other.oldEnt) && other.Ignite(fireStarter)) {
+			if (G_LineOfSight(entity.oldEnt, other->oldEnt) && other->Ignite(fireStarter)) {
 				fireLogger.Notice("Ignited a neighbour, chance to do so was %.0f%%.",
 				                  spreadChance*100.0f);
 			}
 		}
-	});
+	}
+
+	FireBenchmarkThink(start);
 
 	// Don't spread again until re-ignited.
 	spreadAt = INT_MAX;
 }
+
+/** Distance between the buildables of the benchmark, so that every fire can spread to eight. */
+#define FIRE_BENCHMARK_SPACING 80.0f
+
+static void FireBenchmarkEnd(gentity_t* self) {
+	fireBenchmark.running = false;
+
+	double thinkTime = std::chrono::duration<double, std::milli>(fireBenchmark.thinkTime).count();
+	double gridTime  = std::chrono::duration<double, std::milli>(fireBenchmark.gridTime).count();
+
+	Log::Notice("fireBenchmark: %i of %i ignitables left after %is.", (int)ignitableGrid.all.size(),
+	            fireBenchmark.ignitables, fireBenchmark.duration / 1000);
+	Log::Notice("fireBenchmark: %i neighbour walks took %.2fms, %.0fns each.", fireBenchmark.thinks,
+	            thinkTime, fireBenchmark.thinks ? thinkTime * 1000000.0 / fireBenchmark.thinks : 0.0);
+	Log::Notice("fireBenchmark: %i grid changes took %.2fms, %.0fns each.", fireBenchmark.gridChanges,
+	            gridTime, fireBenchmark.gridChanges ? gridTime * 1000000.0 / fireBenchmark.gridChanges : 0.0);
+
+	G_FreeEntity(self);
+}
+
+/** Sets the ignitable closest to the center of the layout on fire and starts measuring. */
+static void FireBenchmarkStart(gentity_t* self) {
+	Entity* closest = nullptr;
+	float closestDistance = 0.0f;
+
+	ForEntities<IgnitableComponent>([&](Entity& entity, IgnitableComponent&) {
+		float distance = Distance(entity.oldEnt->s.origin, self->s.origin);
+
+		if (!closest || distance < closestDistance) {
+			closest = &entity;
+			closestDistance = distance;
+		}
+	});
+
+	if (!closest) {
+		Log::Warn("fireBenchmark: None of the buildables could be spawned.");
+		G_FreeEntity(self);
+		return;
+	}
+
+	fireBenchmark.running     = true;
+	fireBenchmark.thinks      = 0;
+	fireBenchmark.gridChanges = 0;
+	fireBenchmark.thinkTime   = std::chrono::steady_clock::duration::zero();
+	fireBenchmark.gridTime    = std::chrono::steady_clock::duration::zero();
+	fireBenchmark.ignitables  = (int)ignitableGrid.all.size();
+
+	closest->Ignite(&g_entities[ENTITYNUM_WORLD]);
+
+	self->think = FireBenchmarkEnd;
+	self->nextthink = level.time + fireBenchmark.duration;
+}
+
+/**
+ * @brief Lays out acid tubes in a square at the intermission point, sets the one in the middle on
+ *        fire and reports the time spent on neighbours while the fire spreads.
+ *
+ * fireBenchmark [buildables] [seconds]
+ */
+void G_FireBenchmark_f() {
+	char   arg[16];
+	vec3_t origin, angles;
+	int    numBuildables = 100, side;
+
+	if (fireBenchmark.running || G_IterateEntitiesOfClass(nullptr, "fireBenchmark")) {
+		Log::Warn("fireBenchmark: A benchmark is already running.");
+		return;
+	}
+
+	if (trap_Argc() > 1) {
+		trap_Argv(1, arg, sizeof(arg));
+		numBuildables = std::max(1, atoi(arg));
+	}
+
+	fireBenchmark.duration = 30000;
+
+	if (trap_Argc() > 2) {
+		trap_Argv(2, arg, sizeof(arg));
+		fireBenchmark.duration = std::max(1, atoi(arg)) * 1000;
+	}
+
+	G_SelectSpectatorSpawnPoint(origin, angles);
+	side = (int)ceilf(sqrtf((float)numBuildables));
+
+	for (int i = 0; i < numBuildables; i++) {
+		gentity_t* builder = G_NewEntity();
+
+		VectorSet(builder->s.pos.trBase,
+		          origin[0] + ((i % side) - (side - 1) * 0.5f) * FIRE_BENCHMARK_SPACING,
+		          origin[1] + ((i / side) - (side - 1) * 0.5f) * FIRE_BENCHMARK_SPACING,
+		          origin[2]);
+		G_SpawnBuildable(builder, BA_A_ACIDTUBE);
+	}
+
+	// Buildables spawn two frames later.
+	gentity_t* timer = G_NewEntity();
+	timer->classname = "fireBenchmark";
+	VectorCopy(origin, timer->s.origin);
+	timer->think = FireBenchmarkStart;
+	timer->nextthink = level.time + FRAMETIME * 3;
+
+	Log::Notice("fireBenchmark: Spawning %i acid tubes, measuring for %is.", numBuildables,
+	            fireBenchmark.duration / 1000);
+}
@@ -90,18 +90,37 @@ class IgnitableComponent: public IgnitableComponentBase {
 
 		// ///////////////////// //
 
+		~IgnitableComponent();
+
 		void DamageSelf(int timeDelta);
 		void DamageArea(int timeDelta);
 		void ConsiderStop(int timeDelta);
 		void ConsiderSpread(int timeDelta);
 
 	private:
+		/** Other ignitables within spread or extra burn time radius, in entity number order. */
+		const std::vector<Entity*>& Neighbours();
+
+		/** Adds the ignitable to its cell and to the neighbour lists of the ignitables in range. */
+		void AddToGrid();
+
+		/** Removes the ignitable from its cell and from the neighbour lists of its neighbours. */
+		void RemoveFromGrid();
+
+		/** Adds created ignitables to the grid and moves the ones whose origin changed. */
+		static void UpdateGrid();
+
 		bool onFire;
 		int igniteTime;         /**< Time of (re-)ignition. */
 		int immuneUntil;        /**< Fire immunity time after being extinguished. */
 		int spreadAt;           /**< Will try to spread to neighbours at this time. */
 		gentity_t* fireStarter; /**< Client who orginally started the fire. */
 
+		std::vector<Entity*> neighbours;
+		bool inGrid;
+		vec3_t gridOrigin;      /**< Origin the ignitable was sorted into the grid at. */
+		int64_t gridCell;
+
 		std::default_random_engine randomGenerator;
 		std::normal_distribution<float> normalDistribution;
 };
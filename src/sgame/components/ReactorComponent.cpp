@@ -18,7 +18,9 @@ void ReactorComponent::Think(int timeDelta) {
 	float baseDamage = ATTACK_DAMAGE * ((float)timeDelta / 1000.0f);
 
 	// Zap close enemies.
-	ForEntities<AlienClassComponent>([&](Entity& other, AlienClassComponent& alienClassComponent) {
+	G_ForThreatsInRange(entity.oldEnt->s.origin, ATTACK_RANGE, TEAM_HUMANS, [&](Entity& other) {
+		if (!other.Get<AlienClassComponent>()) return;
+
 		// Respect the no-target flag.
 		if (other.oldEnt->flags & FL_NOTARGET) return;
 
@@ -235,7 +235,24 @@ bool RocketpodComponent::EnemyClose() {
 
 	bool enemyClose = false;
 
-	ForEntities<ClientComponent>([&](Entity& other, ClientComponent& clientComponent) {
+	// Bound the search by the largest class, the exact test is done per enemy below.
+	Vec3 podMins, podMaxs;
+	BG_BuildableBoundingBox(BA_H_ROCKETPOD, podMins.Data(), podMaxs.Data());
+
+	float searchRange = missileAttributes->splashRadius + missileAttributes->size +
+		std::max(Math::Length(podMins), Math::Length(podMaxs));
+	float largestEnemyRadius = 0.0f;
+
+	for (int classNum = PCL_NONE + 1; classNum < PCL_NUM_CLASSES; classNum++) {
+		classModelConfig_t* cmc = BG_ClassModelConfig(classNum);
+		largestEnemyRadius = std::max(largestEnemyRadius, std::max(
+			Math::Length(Vec3::Load(cmc->mins)), Math::Length(Vec3::Load(cmc->maxs))
+		));
+	}
+
+	searchRange += largestEnemyRadius;
+
+	G_ForThreatsInRange(entity.oldEnt->s.origin, searchRange, G_Team(entity.oldEnt), [&](Entity& other) {
 		if (enemyClose) return;
 
 		if (other.Get<SpectatorComponent>()) return;
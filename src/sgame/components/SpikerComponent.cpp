@@ -66,11 +66,11 @@ void SpikerComponent::Think(int timeDelta) {
 	bool  sensing = false;
 
 	// Calculate expected damage to decide on the best moment to shoot.
-	ForEntities<HealthComponent>([&](Entity& other, HealthComponent& healthComponent) {
+	G_ForThreatsInRange(entity.oldEnt->s.origin, SPIKE_RANGE, G_Team(entity.oldEnt), [&](Entity& other) {
 		if (G_Team(other.oldEnt) == TEAM_NONE)                            return;
 		if (G_OnSameTeam(entity.oldEnt, other.oldEnt))                    return;
 		if ((other.oldEnt->flags & FL_NOTARGET))                          return;
-		if (!healthComponent.Alive())                                     return;
+		if (!Utility::Alive(other))                                       return;
 		if (G_Distance(entity.oldEnt, other.oldEnt) > SPIKE_RANGE)        return;
 		if (other.Get<BuildableComponent>())                              return;
 		if (!G_LineOfSight(entity.oldEnt, other.oldEnt))                  return;
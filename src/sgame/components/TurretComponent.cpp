@@ -59,7 +59,7 @@ Entity* TurretComponent::FindEntityTarget(std::function<bool(Entity&, Entity&)>
 
 	// Search best target.
 	// TODO: Iterate over all valid targets, do not assume they have to be clients.
-	ForEntities<ClientComponent>([&](Entity& candidate, ClientComponent& clientComponent) {
+	G_ForThreatsInRange(entity.oldEnt->s.origin, range, G_Team(entity.oldEnt), [&](Entity& candidate) {
 		if (TargetValid(candidate, true)) {
 			if (!target || CompareTargets(candidate, *target->entity)) {
 				target = candidate.oldEnt;
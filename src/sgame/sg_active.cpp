@@ -410,6 +410,298 @@ void ClientImpacts( gentity_t *ent, pmove_t *pm )
 	}
 }
 
+/*
+The sensor entities are sorted into a grid of cells on the horizontal plane,
+which G_CM_LinkEntity and G_CM_UnlinkEntity keep up to date through
+G_LinkTrigger and G_UnlinkTrigger. Each client keeps the sensors of its cells
+until it enters other cells or a sensor enters or leaves a cell. Whether a
+sensor is enabled, and its actual bounds, are checked on every query.
+*/
+
+#define TRIGGER_GRID_CELL_SIZE 512.0f
+#define TRIGGER_GRID_MAX_SPAN  64  // larger sensors and queries use every sensor
+
+static struct
+{
+	int                                            version; // changes when a cell gains or loses a sensor
+	std::unordered_map<uint32_t, std::vector<int>> cells;
+	std::vector<int>                               large;   // sorted by entity number
+	std::vector<int>                               all;     // sorted by entity number
+} triggerGrid;
+
+// where each sensor is in the grid
+static struct
+{
+	bool linked;
+	bool large;
+	int  cells[ 4 ];
+} triggerLinks[ MAX_GENTITIES ];
+
+static struct
+{
+	int              version;
+	int              cells[ 4 ];
+	std::vector<int> candidates;
+} triggerCache[ MAX_CLIENTS ];
+
+void G_InitTriggerGrid()
+{
+	triggerGrid.version++;
+	triggerGrid.cells.clear();
+	triggerGrid.large.clear();
+	triggerGrid.all.clear();
+	memset( triggerLinks, 0, sizeof( triggerLinks ) );
+}
+
+/*
+============
+G_TriggerGridCells
+
+Gets the range of cells covered by bounds, returns false if there are too many.
+============
+*/
+static bool G_TriggerGridCells( const vec3_t mins, const vec3_t maxs, int cells[ 4 ] )
+{
+	BG_GridCells( vec3_origin, TRIGGER_GRID_CELL_SIZE, mins, maxs, cells );
+
+	return ( cells[ 2 ] - cells[ 0 ] + 1 ) * ( cells[ 3 ] - cells[ 1 ] + 1 ) <= TRIGGER_GRID_MAX_SPAN;
+}
+
+static void G_TriggerListInsert( std::vector<int> &list, int number )
+{
+	list.insert( std::lower_bound( list.begin(), list.end(), number ), number );
+}
+
+static void G_TriggerListRemove( std::vector<int> &list, int number )
+{
+	auto it = std::find( list.begin(), list.end(), number );
+
+	if ( it != list.end() )
+	{
+		list.erase( it );
+	}
+}
+
+/*
+============
+G_UnlinkTrigger
+
+Takes the entity out of the grid, if it is in there.
+============
+*/
+void G_UnlinkTrigger( gentity_t *ent )
+{
+	int  number = ent->s.number;
+	auto &link = triggerLinks[ number ];
+
+	if ( !link.linked )
+	{
+		return;
+	}
+
+	G_TriggerListRemove( triggerGrid.all, number );
+
+	if ( link.large )
+	{
+		G_TriggerListRemove( triggerGrid.large, number );
+	}
+	else
+	{
+		for ( int y = link.cells[ 1 ]; y <= link.cells[ 3 ]; y++ )
+		{
+			for ( int x = link.cells[ 0 ]; x <= link.cells[ 2 ]; x++ )
+			{
+				auto cell = triggerGrid.cells.find( BG_GridCellKey( x, y ) );
+
+				if ( cell == triggerGrid.cells.end() )
+				{
+					continue;
+				}
+
+				G_TriggerListRemove( cell->second, number );
+
+				if ( cell->second.empty() )
+				{
+					triggerGrid.cells.erase( cell );
+				}
+			}
+		}
+	}
+
+	link.linked = false;
+	triggerGrid.version++;
+}
+
+/*
+============
+G_LinkTrigger
+
+Puts a sensor that was just linked into the cells of its bounds, and takes an
+entity that isn't a sensor anymore out of the grid. A sensor that moves within
+the same cells doesn't change the grid.
+============
+*/
+void G_LinkTrigger( gentity_t *ent )
+{
+	int  number = ent->s.number;
+	auto &link = triggerLinks[ number ];
+	int  cells[ 4 ];
+	bool large;
+
+	if ( number < MAX_CLIENTS || !( ent->r.contents & CONTENTS_SENSOR ) )
+	{
+		G_UnlinkTrigger( ent );
+		return;
+	}
+
+	large = !G_TriggerGridCells( ent->r.absmin, ent->r.absmax, cells );
+
+	if ( link.linked && link.large == large && ( large || !memcmp( link.cells, cells, sizeof( cells ) ) ) )
+	{
+		return;
+	}
+
+	G_UnlinkTrigger( ent );
+
+	G_TriggerListInsert( triggerGrid.all, number );
+
+	if ( large )
+	{
+		G_TriggerListInsert( triggerGrid.large, number );
+	}
+	else
+	{
+		for ( int y = cells[ 1 ]; y <= cells[ 3 ]; y++ )
+		{
+			for ( int x = cells[ 0 ]; x <= cells[ 2 ]; x++ )
+			{
+				triggerGrid.cells[ BG_GridCellKey( x, y ) ].push_back( number );
+			}
+		}
+	}
+
+	link.linked = true;
+	link.large = large;
+	memcpy( link.cells, cells, sizeof( cells ) );
+	triggerGrid.version++;
+}
+
+/*
+============
+G_TriggerGridCandidates
+
+Collects the sensors of the cells in entity number order.
+============
+*/
+static void G_TriggerGridCandidates( const int cells[ 4 ], std::vector<int> &candidates )
+{
+	candidates = triggerGrid.large;
+
+	for ( int y = cells[ 1 ]; y <= cells[ 3 ]; y++ )
+	{
+		for ( int x = cells[ 0 ]; x <= cells[ 2 ]; x++ )
+		{
+			auto cell = triggerGrid.cells.find( BG_GridCellKey( x, y ) );
+
+			if ( cell != triggerGrid.cells.end() )
+			{
+				candidates.insert( candidates.end(), cell->second.begin(), cell->second.end() );
+			}
+		}
+	}
+
+	std::sort( candidates.begin(), candidates.end() );
+	candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+}
+
+/*
+============
+G_FilterTriggers
+
+Keeps the candidates that are still sensors and whose bounds touch the box,
+like trap_EntitiesInBox would.
+============
+*/
+static int G_FilterTriggers( const std::vector<int> &candidates, const vec3_t mins, const vec3_t maxs,
+                             int *list, int maxcount )
+{
+	int num = 0;
+
+	for ( int number : candidates )
+	{
+		gentity_t *ent = &g_entities[ number ];
+
+		if ( num >= maxcount )
+		{
+			break;
+		}
+
+		if ( !ent->inuse || !ent->r.linked || !( ent->r.contents & CONTENTS_SENSOR ) )
+		{
+			continue;
+		}
+
+		if ( ent->r.absmin[ 0 ] > maxs[ 0 ] || ent->r.absmin[ 1 ] > maxs[ 1 ] || ent->r.absmin[ 2 ] > maxs[ 2 ] ||
+		     ent->r.absmax[ 0 ] < mins[ 0 ] || ent->r.absmax[ 1 ] < mins[ 1 ] || ent->r.absmax[ 2 ] < mins[ 2 ] )
+		{
+			continue;
+		}
+
+		list[ num++ ] = number;
+	}
+
+	return num;
+}
+
+/*
+============
+G_TriggersInBox
+
+Like trap_EntitiesInBox, for sensor entities only.
+============
+*/
+int G_TriggersInBox( const vec3_t mins, const vec3_t maxs, int *list, int maxcount )
+{
+	static std::vector<int> candidates;
+	int cells[ 4 ];
+
+	if ( !G_TriggerGridCells( mins, maxs, cells ) )
+	{
+		return G_FilterTriggers( triggerGrid.all, mins, maxs, list, maxcount );
+	}
+
+	G_TriggerGridCandidates( cells, candidates );
+
+	return G_FilterTriggers( candidates, mins, maxs, list, maxcount );
+}
+
+/*
+============
+G_ClientTriggersInBox
+
+G_TriggersInBox, using the sensors cached for the client.
+============
+*/
+static int G_ClientTriggersInBox( gentity_t *ent, const vec3_t mins, const vec3_t maxs, int *list, int maxcount )
+{
+	int cells[ 4 ];
+	auto &cache = triggerCache[ ent->client->ps.clientNum ];
+
+	if ( !G_TriggerGridCells( mins, maxs, cells ) )
+	{
+		return G_FilterTriggers( triggerGrid.all, mins, maxs, list, maxcount );
+	}
+
+	if ( cache.version != triggerGrid.version || memcmp( cache.cells, cells, sizeof( cells ) ) )
+	{
+		G_TriggerGridCandidates( cells, cache.candidates );
+		cache.version = triggerGrid.version;
+		memcpy( cache.cells, cells, sizeof( cells ) );
+	}
+
+	return G_FilterTriggers( cache.candidates, mins, maxs, list, maxcount );
+}
+
 /*
 ============
 G_TouchTriggers
@@ -454,7 +746,7 @@ void  G_TouchTriggers( gentity_t *ent )
 	VectorSubtract( mins, range, mins );
 	VectorAdd( maxs, range, maxs );
 
-	num = trap_EntitiesInBox( mins, maxs, touch, MAX_GENTITIES );
+	num = G_ClientTriggersInBox( ent, mins, maxs, touch, MAX_GENTITIES );
 
 	// can't use ent->absmin, because that has a one unit pad
 	VectorAdd( ent->client->ps.origin, ent->r.mins, mins );
@@ -646,7 +938,9 @@ void SpectatorThink( gentity_t *ent, usercmd_t *ucmd )
 		pm.pointcontents = trap_PointContents;
 
 		// Perform a pmove
+		G_PmoveRecordInput( &pm );
 		Pmove( &pm );
+		G_PmoveRecordOutput( &pm );
 
 		// Save results of pmove
 		VectorCopy( client->ps.origin, ent->s.origin );
@@ -859,6 +1153,125 @@ static void BeaconAutoTag( gentity_t *self, int timePassed )
 	}
 }
 
+#define BUILD_PREVIEW_MOVE    2.0f // units the builder may move before the preview is checked again
+#define BUILD_PREVIEW_TURN    0.5f // degrees the builder may turn
+#define BUILD_PREVIEW_MAX_AGE 500  // ms, for what isn't tracked, like players in the way
+
+static struct
+{
+	buildable_t buildable;
+	int         time;
+	vec3_t      origin, viewangles, normal;
+	int         signature, freeBudget, allowBuilding;
+	int         state, prediction;
+	int         misc[ MAX_MISC ];
+} buildPreview[ MAX_CLIENTS ];
+
+/*
+==================
+G_UpdateBuildPreview
+
+Tells the builder whether the buildable can be placed where it aims, what it
+would replace and, for miners, how the mining efficiency would change. The
+result is reused while the builder, the buildables and the budget stay the
+same, since checking it traces a lot.
+==================
+*/
+static void G_UpdateBuildPreview( gentity_t *ent, buildable_t buildable )
+{
+	gclient_t *client = ent->client;
+	team_t    team = (team_t) client->ps.persistant[ PERS_TEAM ];
+	auto      &cache = buildPreview[ client->ps.clientNum ];
+	vec3_t    forward, aimDir, normal;
+	int       signature, freeBudget, allowBuilding;
+	bool      turned = false;
+	int       i;
+
+	BG_GetClientNormal( &client->ps, normal );
+	signature = G_BuildableSetSignature();
+	freeBudget = G_GetFreeBudget( team );
+	allowBuilding = team == TEAM_ALIENS ? g_alienAllowBuilding.integer : g_humanAllowBuilding.integer;
+
+	for ( i = 0; i < 3; i++ )
+	{
+		if ( fabsf( AngleSubtract( cache.viewangles[ i ], client->ps.viewangles[ i ] ) ) > BUILD_PREVIEW_TURN )
+		{
+			turned = true;
+		}
+	}
+
+	if ( cache.buildable != buildable || turned || level.time < cache.time ||
+	     level.time - cache.time >= BUILD_PREVIEW_MAX_AGE ||
+	     Distance( cache.origin, client->ps.origin ) > BUILD_PREVIEW_MOVE ||
+	     !VectorCompare( cache.normal, normal ) || cache.signature != signature ||
+	     cache.freeBudget != freeBudget || cache.allowBuilding != allowBuilding )
+	{
+		vec3_t origin, groundNormal;
+		int    groundEntNum;
+		int    dist;
+
+		AngleVectors( client->ps.viewangles, aimDir, nullptr, nullptr );
+		ProjectPointOnPlane( forward, aimDir, normal );
+		VectorNormalize( forward );
+
+		dist = BG_Class( client->ps.stats[ STAT_CLASS ] )->buildDist * DotProduct( forward, aimDir );
+
+		cache.buildable = buildable;
+		cache.time = level.time;
+		VectorCopy( client->ps.origin, cache.origin );
+		VectorCopy( client->ps.viewangles, cache.viewangles );
+		VectorCopy( normal, cache.normal );
+		cache.signature = signature;
+		cache.freeBudget = freeBudget;
+		cache.allowBuilding = allowBuilding;
+
+		cache.state = SB_BUILDABLE_FROM_IBE( G_CanBuild( ent, buildable, dist, origin, groundNormal, &groundEntNum ) );
+		cache.prediction = client->ps.stats[ STAT_PREDICTION ];
+
+		if ( buildable == BA_H_DRILL || buildable == BA_A_LEECH )
+		{
+			float deltaEff = G_RGSPredictEfficiencyDelta(origin, team);
+			int   deltaBP  = (int)(level.team[team].totalBudget + deltaEff *
+			                       g_buildPointBudgetPerMiner.value) -
+			                 (int)(level.team[team].totalBudget);
+
+			signed char deltaEffNetwork = (signed char)((float)0x7f * deltaEff);
+			signed char deltaBPNetwork  = (signed char)deltaBP;
+
+			unsigned int deltasNetwork = (unsigned char)deltaEffNetwork |
+			                             (unsigned char)deltaBPNetwork << 8;
+
+			// The efficiency and budget deltas are signed values that are encode as the
+			// least and most significant byte of the de-facto short
+			// ps->stats[STAT_PREDICTION], respectively. The efficiency delta is a value
+			// between -1 and 1, the budget delta is an integer between -128 and 127.
+			cache.prediction = (int)deltasNetwork;
+		}
+
+		// Let the client know which buildables will be removed by building
+		for ( i = 0; i < MAX_MISC; i++ )
+		{
+			if ( i < level.numBuildablesForRemoval )
+			{
+				cache.misc[ i ] = level.markedBuildables[ i ]->s.number;
+			}
+			else
+			{
+				cache.misc[ i ] = 0;
+			}
+		}
+	}
+
+	client->ps.stats[ STAT_BUILDABLE ] &= ~SB_BUILDABLE_STATE_MASK;
+	client->ps.stats[ STAT_BUILDABLE ] |= cache.state;
+	client->ps.stats[ STAT_PREDICTION ] = cache.prediction;
+
+	for ( i = 0; i < MAX_MISC; i++ )
+	{
+		client->ps.misc[ i ] = cache.misc[ i ];
+	}
+}
+
 /*
 ==================
 ClientTimerActions
@@ -919,53 +1332,7 @@ void ClientTimerActions( gentity_t *ent, int msec )
 				// Set validity bit on buildable
 				if ( buildable > BA_NONE )
 				{
-					vec3_t forward, aimDir, normal;
-					vec3_t dummy, dummy2;
-					int dummy3;
-					int dist;
-
-					BG_GetClientNormal( &client->ps,normal );
-					AngleVectors( client->ps.viewangles, aimDir, nullptr, nullptr );
-					ProjectPointOnPlane( forward, aimDir, normal );
-					VectorNormalize( forward );
-
-					dist = BG_Class( ent->client->ps.stats[ STAT_CLASS ] )->buildDist * DotProduct( forward, aimDir );
-
-					client->ps.stats[ STAT_BUILDABLE ] &= ~SB_BUILDABLE_STATE_MASK;
-					client->ps.stats[ STAT_BUILDABLE ] |= SB_BUILDABLE_FROM_IBE( G_CanBuild( ent, buildable, dist, dummy, dummy2, &dummy3 ) );
-
-					if ( buildable == BA_H_DRILL || buildable == BA_A_LEECH )
-					{
-						float deltaEff = G_RGSPredictEfficiencyDelta(dummy, team);
-						int   deltaBP  = (int)(level.team[team].totalBudget + deltaEff *
-						                       g_buildPointBudgetPerMiner.value) -
-						                 (int)(level.team[team].totalBudget);
-
-						signed char deltaEffNetwork = (signed char)((float)0x7f * deltaEff);
-						signed char deltaBPNetwork  = (signed char)deltaBP;
-
-						unsigned int deltasNetwork = (unsigned char)deltaEffNetwork |
-						                             (unsigned char)deltaBPNetwork << 8;
-
-						// The efficiency and budget deltas are signed values that are encode as the
-						// least and most significant byte of the de-facto short
-						// ps->stats[STAT_PREDICTION], respectively. The efficiency delta is a value
-						// between -1 and 1, the budget delta is an integer between -128 and 127.
-						client->ps.stats[STAT_PREDICTION] = (int)deltasNetwork;
-					}
-
-					// Let the client know which buildables will be removed by building
-					for ( i = 0; i < MAX_MISC; i++ )
-					{
-						if ( i < level.numBuildablesForRemoval )
-						{
-							client->ps.misc[ i ] = level.markedBuildables[ i ]->s.number;
-						}
-						else
-						{
-							client->ps.misc[ i ] = 0;
-						}
-					}
+					G_UpdateBuildPreview( ent, buildable );
 				}
 				else
 				{
@@ -2038,7 +2405,9 @@ void ClientThink_real( gentity_t *self )
 	// Do this before Pmove because it is shared code and accesses networked fields.
 	G_PrepareEntityNetCode();
 
+	G_PmoveRecordInput( &pm );
 	Pmove( &pm );
+	G_PmoveRecordOutput( &pm );
 
 	G_UnlaggedDetectCollisions( self );
 
@@ -190,6 +190,7 @@ bool G_BotSetDefaults( int clientNum, team_t team, int skill, const char* behavi
 	botMind->numRunningNodes = 0;
 	botMind->currentNode = nullptr;
 	memset( &botMind->nav, 0, sizeof( botMind->nav ) );
+	botMind->navTraceFrame = -1;
 	BotResetEnemyQueue( &botMind->enemyQueue );
 
 	botMind->behaviorTree = ReadBehaviorTree( behavior, &treeList );
@@ -469,6 +470,7 @@ void G_BotSpectatorThink( gentity_t *self )
 	BotResetEnemyQueue( &self->botMind->enemyQueue );
 	self->botMind->currentNode = nullptr;
 	memset( &self->botMind->nav, 0, sizeof( self->botMind->nav ) );
+	self->botMind->navTraceFrame = -1;
 	self->botMind->futureAimTime = 0;
 	self->botMind->futureAimTimeInterval = 0;
 	self->botMind->numRunningNodes = 0;
@@ -89,6 +89,12 @@ typedef struct
 	usercmd_t   cmdBuffer;
 	botNavCmd_t nav;
 
+	// last navmesh raycast of BotPathIsWalkable, reused for the rest of the frame
+	int    navTraceFrame;
+	vec3_t navTraceStart;
+	vec3_t navTraceEnd;
+	bool   navTraceWalkable;
+
 	int lastThink;
 	int stuckTime;
 	vec3_t stuckPosition;
@@ -204,24 +204,27 @@ bool BotPathIsWalkable( gentity_t *self, botTarget_t target )
 	vec3_t selfPos, targetPos;
 	vec3_t viewNormal;
 	botTrace_t trace;
+	botMemory_t *mind = self->botMind;
 
 	BG_GetClientNormal( &self->client->ps, viewNormal );
 	VectorMA( self->s.origin, self->r.mins[2], viewNormal, selfPos );
 	BotGetTargetPos( target, targetPos );
 
-	if ( !trap_BotNavTrace( self->s.number, &trace, selfPos, targetPos ) )
+	// behavior trees tend to ask the same question several times per think
+	if ( mind->navTraceFrame == level.framenum &&
+	     VectorCompare( mind->navTraceStart, selfPos ) &&
+	     VectorCompare( mind->navTraceEnd, targetPos ) )
 	{
-		return false;
+		return mind->navTraceWalkable;
 	}
 
-	if ( trace.frac >= 1.0f )
-	{
-		return true;
-	}
-	else
-	{
-		return false;
-	}
+	mind->navTraceFrame = level.framenum;
+	VectorCopy( selfPos, mind->navTraceStart );
+	VectorCopy( targetPos, mind->navTraceEnd );
+	mind->navTraceWalkable = trap_BotNavTrace( self->s.number, &trace, selfPos, targetPos ) &&
+	                         trace.frac >= 1.0f;
+
+	return mind->navTraceWalkable;
 }
 
 void BotFindRandomPointOnMesh( gentity_t *self, vec3_t point )
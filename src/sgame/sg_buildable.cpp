@@ -25,6 +25,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "sg_local.h"
+#include "sg_cm_world.h"
 #include "CBSE.h"
 
 /**
@@ -772,14 +773,41 @@ static bool CompareBuildablesForPowerSaving(Entity* a, Entity* b)
 	return (G_DistanceToBase(a->oldEnt) > G_DistanceToBase(b->oldEnt));
 }
 
+static struct {
+	int version = 0;        /**< Changes with the buildables or their state. */
+	int checkedVersion = -1;
+	int spentBudget[NUM_TEAMS];
+	int totalBudget[NUM_TEAMS];
+} powerStates;
+
+/**
+ * @brief Has the power states recomputed on the next frame. To be called when a buildable is
+ *        created, removed, marked, finishes construction, dies or changes its power state.
+ */
+void G_InvalidateBuildablePowerStates()
+{
+	powerStates.version++;
+}
+
 /**
  * @brief Set the power state of both team's buildables based on budget deficits.
+ *
+ * A team is only checked again if its buildables or its budget changed since the last check.
  */
 void G_UpdateBuildablePowerStates()
 {
 	gentity_t* activeMainBuildable;
+	bool       changed = (powerStates.checkedVersion != powerStates.version);
 
 	for (team_t team = TEAM_NONE; (team = G_IterateTeams(team)); ) {
+		if (!changed && powerStates.spentBudget[team] == level.team[team].spentBudget &&
+		    powerStates.totalBudget[team] == (int)level.team[team].totalBudget) {
+			continue;
+		}
+
+		powerStates.spentBudget[team] = level.team[team].spentBudget;
+		powerStates.totalBudget[team] = (int)level.team[team].totalBudget;
+
 		std::vector<Entity*> poweredBuildables;
 		std::vector<Entity*> unpoweredBuildables;
 		int unpoweredBuildableTotal = 0;
@@ -849,6 +877,9 @@ void G_UpdateBuildablePowerStates()
 			}
 		}
 	}
+
+	// The power changes made above only affect their own team, which was just resolved.
+	powerStates.checkedVersion = powerStates.version;
 }
 
 /**
@@ -878,7 +909,7 @@ void G_BuildableTouchTriggers( gentity_t *ent )
 	VectorSubtract( mins, range, mins );
 	VectorAdd( maxs, range, maxs );
 
-	num = trap_EntitiesInBox( mins, maxs, touch, MAX_GENTITIES );
+	num = G_TriggersInBox( mins, maxs, touch, MAX_GENTITIES );
 
 	VectorAdd( ent->s.origin, bmins, mins );
 	VectorAdd( ent->s.origin, bmaxs, maxs );
@@ -1425,47 +1456,72 @@ static itemBuildError_t PrepareBuildableReplacement( buildable_t buildable, vec3
 	}
 }
 
-static void SetBuildableLinkState( bool link )
+/**
+ * @brief A checksum of the buildables and of their states that G_CanBuild depends on, so that
+ *        build checks can be reused while it stays the same. Computed once per frame.
+ */
+int G_BuildableSetSignature()
 {
-	int       i;
-	gentity_t *ent;
-
-	for ( i = MAX_CLIENTS, ent = g_entities + i; i < level.num_entities; i++, ent++ )
-	{
-		if ( ent->s.eType != entityType_t::ET_BUILDABLE )
-		{
-			continue;
-		}
+	static int time = -1, signature;
 
-		if ( link )
-		{
-			trap_LinkEntity( ent );
-		}
-		else
-		{
-			trap_UnlinkEntity( ent );
-		}
+	if (time == level.time) {
+		return signature;
 	}
+
+	uint32_t hash = 2166136261u;
+
+	auto mix = [&hash](int value) {
+		hash = (hash ^ (uint32_t)value) * 16777619u;
+	};
+
+	ForEntities<BuildableComponent>([&](Entity& entity, BuildableComponent& buildableComponent) {
+		gentity_t *ent = entity.oldEnt;
+
+		mix(ent->s.number);
+		mix(ent->s.modelindex);
+		mix(ent->spawned | (ent->powered << 1) | (G_Alive(ent) << 2) |
+		    (buildableComponent.MarkedForDeconstruction() << 3));
+		mix((int)ent->r.currentOrigin[0]);
+		mix((int)ent->r.currentOrigin[1]);
+		mix((int)ent->r.currentOrigin[2]);
+	});
+
+	time = level.time;
+	signature = (int)hash;
+
+	return signature;
 }
 
-static void SetBuildableMarkedLinkState( bool link )
+static bool BuildableHidden( const gentity_t *ent )
 {
-	int       i;
-	gentity_t *ent;
+	return ent->s.eType == entityType_t::ET_BUILDABLE;
+}
 
-	for ( i = 0; i < level.numBuildablesForRemoval; i++ )
+static bool MarkedBuildableHidden( const gentity_t *ent )
+{
+	for ( int i = 0; i < level.numBuildablesForRemoval; i++ )
 	{
-		ent = level.markedBuildables[ i ];
-
-		if ( link )
-		{
-			trap_LinkEntity( ent );
-		}
-		else
+		if ( level.markedBuildables[ i ] == ent )
 		{
-			trap_UnlinkEntity( ent );
+			return true;
 		}
 	}
+
+	return false;
+}
+
+/*
+Hides the buildables from traces and point contents instead of unlinking them,
+relinking every buildable on every check is expensive.
+*/
+static void SetBuildableLinkState( bool link )
+{
+	G_CM_SetHiddenEntities( link ? nullptr : BuildableHidden );
+}
+
+static void SetBuildableMarkedLinkState( bool link )
+{
+	G_CM_SetHiddenEntities( link ? nullptr : MarkedBuildableHidden );
 }
 
 itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distance*/, //TODO
@@ -2463,6 +2519,8 @@ void G_BuildLogSet( buildLog_t *log, gentity_t *ent )
 	VectorCopy( ent->s.angles, log->angles );
 	VectorCopy( ent->s.origin2, log->origin2 );
 	VectorCopy( ent->s.angles2, log->angles2 );
+
+	G_EventLogBuild( log );
 }
 
 void G_BuildLogAuto( gentity_t *actor, gentity_t *buildable, buildFate_t fate )
@@ -41,6 +41,10 @@ typedef struct worldEntity_s
 {
 	struct worldSector_s *worldSector;
 	struct worldEntity_s *nextEntityInWorldSector;
+
+	// also chained in worldSector->pushables if movers can push it
+	bool                 pushable;
+	struct worldEntity_s *nextPushableInWorldSector;
 } worldEntity_t;
 
 worldEntity_t wentities[ MAX_GENTITIES ];
@@ -246,6 +250,7 @@ typedef struct worldSector_s
 	struct worldSector_s *children[ 2 ];
 
 	worldEntity_t        *entities;
+	worldEntity_t        *pushables; // the entities G_Pushable is true for, in the same order
 } worldSector_t;
 
 #define AREA_DEPTH 4
@@ -254,6 +259,19 @@ typedef struct worldSector_s
 worldSector_t sv_worldSectors[ AREA_NODES ];
 int           sv_numworldSectors;
 
+// entities left out of the world queries while they would be in the way
+static bool ( *hiddenEntities )( const gentity_t *ent );
+
+/*
+===============
+G_CM_SetHiddenEntities
+===============
+*/
+void G_CM_SetHiddenEntities( bool ( *hidden )( const gentity_t *ent ) )
+{
+	hiddenEntities = hidden;
+}
+
 /*
 ===============
 G_CM_SectorList_f
@@ -351,11 +369,12 @@ void G_CM_ClearWorld()
 
 /*
 ===============
-G_CM_UnlinkEntity
+G_CM_UnlinkFromWorldSector
 
+Takes the entity out of the sector it is linked in, if any
 ===============
 */
-void G_CM_UnlinkEntity( gentity_t *gEnt )
+static void G_CM_UnlinkFromWorldSector( gentity_t *gEnt )
 {
 	worldEntity_t* scan;
 	worldSector_t* ws;
@@ -373,6 +392,23 @@ void G_CM_UnlinkEntity( gentity_t *gEnt )
 
 	went->worldSector = nullptr;
 
+	if ( went->pushable )
+	{
+		worldEntity_t **link = &ws->pushables;
+
+		while ( *link && *link != went )
+		{
+			link = &( *link )->nextPushableInWorldSector;
+		}
+
+		if ( *link )
+		{
+			*link = went->nextPushableInWorldSector;
+		}
+
+		went->pushable = false;
+	}
+
 	if ( ws->entities == went )
 	{
 		ws->entities = went->nextEntityInWorldSector;
@@ -391,6 +427,18 @@ void G_CM_UnlinkEntity( gentity_t *gEnt )
 	Log::Warn( "G_CM_UnlinkEntity: not found in worldSector\n" );
 }
 
+/*
+===============
+G_CM_UnlinkEntity
+
+===============
+*/
+void G_CM_UnlinkEntity( gentity_t *gEnt )
+{
+	G_CM_UnlinkFromWorldSector( gEnt );
+	G_UnlinkTrigger( gEnt );
+}
+
 /*
 ===============
 G_CM_LinkEntity
@@ -413,7 +461,7 @@ void G_CM_LinkEntity( gentity_t *gEnt )
 
 	if ( went->worldSector )
 	{
-		G_CM_UnlinkEntity( gEnt );  // unlink from old position
+		G_CM_UnlinkFromWorldSector( gEnt );  // unlink from old position, the trigger grid is updated below
 	}
 
 	// encode the size into the entityState_t for client prediction
@@ -519,6 +567,7 @@ void G_CM_LinkEntity( gentity_t *gEnt )
 	// entity is outside the world and can be considered unlinked
 	if ( !num_leafs )
 	{
+		G_UnlinkTrigger( gEnt );
 		return;
 	}
 
@@ -597,7 +646,17 @@ void G_CM_LinkEntity( gentity_t *gEnt )
 	went->nextEntityInWorldSector = node->entities;
 	node->entities = went;
 
+	if ( G_Pushable( gEnt ) )
+	{
+		went->pushable = true;
+		went->nextPushableInWorldSector = node->pushables;
+		node->pushables = went;
+	}
+
 	gEnt->r.linked = true;
+
+	// sensors are also sorted into the grid G_TouchTriggers queries
+	G_LinkTrigger( gEnt );
 }
 
 /*
@@ -616,6 +675,7 @@ typedef struct
 	const float *maxs;
 	int         *list;
 	int         count, maxcount;
+	bool        pushables; // only walk the pushable chains
 } areaParms_t;
 
 /*
@@ -632,13 +692,13 @@ void G_CM_AreaEntities_r( worldSector_t *node, areaParms_t *ap )
 
 //	count = 0;
 
-	for ( check = node->entities; check; check = next )
+	for ( check = ap->pushables ? node->pushables : node->entities; check; check = next )
 	{
-		next = check->nextEntityInWorldSector;
+		next = ap->pushables ? check->nextPushableInWorldSector : check->nextEntityInWorldSector;
 
 		gcheck = G_CM_GEntityForWorldEntity( check );
 
-		if ( !gcheck->r.linked )
+		if ( !gcheck->r.linked || ( hiddenEntities && hiddenEntities( gcheck ) ) )
 		{
 			continue;
 		}
@@ -692,6 +752,28 @@ int G_CM_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entityList, in
 	ap.list = entityList;
 	ap.count = 0;
 	ap.maxcount = maxcount;
+	ap.pushables = false;
+
+	G_CM_AreaEntities_r( sv_worldSectors, &ap );
+
+	return ap.count;
+}
+
+/*
+================
+G_CM_AreaPushables
+================
+*/
+int G_CM_AreaPushables( const vec3_t mins, const vec3_t maxs, int *entityList, int maxcount )
+{
+	areaParms_t ap;
+
+	ap.mins = mins;
+	ap.maxs = maxs;
+	ap.list = entityList;
+	ap.count = 0;
+	ap.maxcount = maxcount;
+	ap.pushables = true;
 
 	G_CM_AreaEntities_r( sv_worldSectors, &ap );
 
@@ -56,6 +56,11 @@ void G_CM_LinkEntity( gentity_t *ent );
 // sets ent->leafnums[] for pvs determination even if the entity
 // is not solid
 
+void G_CM_SetHiddenEntities( bool ( *hidden )( const gentity_t *ent ) );
+
+// entities for which hidden returns true are left out of all world queries,
+// as if they were unlinked, until it is called again with nullptr
+
 clipHandle_t G_CM_ClipHandleForEntity( const sharedEntity_t *ent );
 
 void         G_CM_SectorList_f();
@@ -69,6 +74,11 @@ int          G_CM_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entit
 // returns the number of pointers filled in
 // The world entity is never returned in this list.
 
+int G_CM_AreaPushables( const vec3_t mins, const vec3_t maxs, int *entityList, int maxcount );
+
+// same as G_CM_AreaEntities, but only lists the entities that were pushable
+// when they were linked, see G_Pushable
+
 int G_CM_PointContents( const vec3_t p, int passEntityNum );
 
 // returns the CONTENTS_* value from the world and all entities at the given point.
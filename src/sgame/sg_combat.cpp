@@ -401,6 +401,8 @@ void G_PlayerDie( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, in
 		             self->client->pers.netname );
 	}
 
+	G_EventLogKill( self, killer, assistant, assistantTeam, ( meansOfDeath_t ) meansOfDeath );
+
 	// deactivate all upgrades
 	for ( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++ )
 	{
@@ -789,94 +791,77 @@ void G_SelectiveDamage( gentity_t *targ, gentity_t *inflictor, gentity_t *attack
 	}
 }
 
+#define CAN_DAMAGE_TRACES 5
+
 /**
- * @brief Used for explosions and melee attacks.
- * @param targ
- * @param origin
- * @return true if the inflictor can directly damage the target.
+ * @brief One of the traces of G_CanDamage: first to the midpoint of the target, then to four
+ *        points around it.
+ * @return true if the trace reaches the target.
  */
-bool G_CanDamage( gentity_t *targ, vec3_t origin )
+static bool G_CanDamageTrace( gentity_t *targ, vec3_t origin, int traceNum )
 {
+	static const float offsets[ CAN_DAMAGE_TRACES ][ 2 ] =
+	{
+		{ 0.0f, 0.0f }, { 15.0f, 15.0f }, { 15.0f, -15.0f }, { -15.0f, 15.0f }, { -15.0f, -15.0f }
+	};
+
 	vec3_t  dest;
 	trace_t tr;
-	vec3_t  midpoint;
 
 	// use the midpoint of the bounds instead of the origin, because
 	// bmodels may have their origin is 0,0,0
-	VectorAdd( targ->r.absmin, targ->r.absmax, midpoint );
-	VectorScale( midpoint, 0.5, midpoint );
-
-	VectorCopy( midpoint, dest );
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
-
-	if ( tr.fraction == 1.0  || tr.entityNum == targ->s.number )
-	{
-		return true;
-	}
+	VectorAdd( targ->r.absmin, targ->r.absmax, dest );
+	VectorScale( dest, 0.5, dest );
 
 	// this should probably check in the plane of projection,
 	// rather than in world coordinate, and also include Z
-	VectorCopy( midpoint, dest );
-	dest[ 0 ] += 15.0;
-	dest[ 1 ] += 15.0;
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
-
-	if ( tr.fraction == 1.0 )
-	{
-		return true;
-	}
+	dest[ 0 ] += offsets[ traceNum ][ 0 ];
+	dest[ 1 ] += offsets[ traceNum ][ 1 ];
 
-	VectorCopy( midpoint, dest );
-	dest[ 0 ] += 15.0;
-	dest[ 1 ] -= 15.0;
 	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
 
-	if ( tr.fraction == 1.0 )
-	{
-		return true;
-	}
-
-	VectorCopy( midpoint, dest );
-	dest[ 0 ] -= 15.0;
-	dest[ 1 ] += 15.0;
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
-
-	if ( tr.fraction == 1.0 )
-	{
-		return true;
-	}
-
-	VectorCopy( midpoint, dest );
-	dest[ 0 ] -= 15.0;
-	dest[ 1 ] -= 15.0;
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
+	return ( tr.fraction == 1.0 || ( traceNum == 0 && tr.entityNum == targ->s.number ) );
+}
 
-	if ( tr.fraction == 1.0 )
+/**
+ * @brief Used for explosions and melee attacks.
+ * @param targ
+ * @param origin
+ * @return true if the inflictor can directly damage the target.
+ */
+bool G_CanDamage( gentity_t *targ, vec3_t origin )
+{
+	for ( int traceNum = 0; traceNum < CAN_DAMAGE_TRACES; traceNum++ )
 	{
-		return true;
+		if ( G_CanDamageTrace( targ, origin, traceNum ) )
+		{
+			return true;
+		}
 	}
 
 	return false;
 }
 
-bool G_SelectiveRadiusDamage( vec3_t origin, gentity_t *attacker, float damage,
-                                  float radius, gentity_t *ignore, int mod, int ignoreTeam )
+struct splashTarget_t
 {
-	float     points, dist;
 	gentity_t *ent;
-	int       entityList[ MAX_GENTITIES ];
-	int       numListedEntities;
-	vec3_t    mins, maxs;
-	vec3_t    v;
-	int       i, e;
-	bool  hitClient = false;
+	float     points;
+	bool      visible;
+};
 
-	if ( radius < 1 )
-	{
-		radius = 1;
-	}
+/**
+ * @brief Lists the entities that pass the filter and are within radius of origin, with the
+ *        damage the splash deals to them. Visibility is left to G_SplashVisibility.
+ * @return The number of targets.
+ */
+static int G_SplashTargets( vec3_t origin, float damage, float radius, gentity_t *ignore,
+                            const std::function<bool(gentity_t*)> &filter, splashTarget_t *targets )
+{
+	int    entityList[ MAX_GENTITIES ];
+	int    numListedEntities, numTargets = 0;
+	vec3_t mins, maxs, v;
 
-	for ( i = 0; i < 3; i++ )
+	for ( int i = 0; i < 3; i++ )
 	{
 		mins[ i ] = origin[ i ] - radius;
 		maxs[ i ] = origin[ i ] + radius;
@@ -884,22 +869,17 @@ bool G_SelectiveRadiusDamage( vec3_t origin, gentity_t *attacker, float damage,
 
 	numListedEntities = trap_EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
 
-	for ( e = 0; e < numListedEntities; e++ )
+	for ( int e = 0; e < numListedEntities; e++ )
 	{
-		ent = &g_entities[ entityList[ e ] ];
+		gentity_t *ent = &g_entities[ entityList[ e ] ];
 
-		if ( ent == ignore )
-		{
-			continue;
-		}
-
-		if ( ent->flags & FL_NOTARGET )
+		if ( ent == ignore || !filter( ent ) )
 		{
 			continue;
 		}
 
 		// find the distance from the edge of the bounding box
-		for ( i = 0; i < 3; i++ )
+		for ( int i = 0; i < 3; i++ )
 		{
 			if ( origin[ i ] < ent->r.absmin[ i ] )
 			{
@@ -915,104 +895,132 @@ bool G_SelectiveRadiusDamage( vec3_t origin, gentity_t *attacker, float damage,
 			}
 		}
 
-		dist = VectorLength( v );
+		float dist = VectorLength( v );
 
 		if ( dist >= radius )
 		{
 			continue;
 		}
 
-		points = damage * ( 1.0 - dist / radius );
+		targets[ numTargets ].ent = ent;
+		targets[ numTargets ].points = damage * ( 1.0 - dist / radius );
+		targets[ numTargets ].visible = false;
+		numTargets++;
+	}
+
+	return numTargets;
+}
 
-		if ( G_CanDamage( ent, origin ) && ent->client &&
-		     ent->client->pers.team != ignoreTeam )
+/**
+ * @brief G_CanDamage for all targets of a splash. Every trace is done for the targets that no
+ *        earlier one reached, before the damage is dealt.
+ */
+static void G_SplashVisibility( vec3_t origin, splashTarget_t *targets, int numTargets )
+{
+	int numHidden = numTargets;
+
+	for ( int traceNum = 0; traceNum < CAN_DAMAGE_TRACES && numHidden > 0; traceNum++ )
+	{
+		for ( int t = 0; t < numTargets; t++ )
 		{
-			hitClient = ent->entity->Damage(points, attacker, Vec3::Load(origin), Util::nullopt,
-			                                DAMAGE_NO_LOCDAMAGE, (meansOfDeath_t)mod);
+			if ( !targets[ t ].visible && G_CanDamageTrace( targets[ t ].ent, origin, traceNum ) )
+			{
+				targets[ t ].visible = true;
+				numHidden--;
+			}
 		}
 	}
-
-	return hitClient;
 }
 
-bool G_RadiusDamage( vec3_t origin, gentity_t *attacker, float damage,
-                         float radius, gentity_t *ignore, int dflags, int mod, team_t testHit )
+bool G_SelectiveRadiusDamage( vec3_t origin, gentity_t *attacker, float damage,
+                                  float radius, gentity_t *ignore, int mod, int ignoreTeam )
 {
-	float     points, dist;
-	gentity_t *ent;
-	int       entityList[ MAX_GENTITIES ];
-	int       numListedEntities;
-	vec3_t    mins, maxs;
-	vec3_t    v;
-	vec3_t    dir;
-	int       i, e;
-	bool  hitSomething = false;
+	splashTarget_t targets[ MAX_GENTITIES ];
+	int            numTargets;
+	bool       hitClient = false;
 
 	if ( radius < 1 )
 	{
 		radius = 1;
 	}
 
-	for ( i = 0; i < 3; i++ )
+	numTargets = G_SplashTargets( origin, damage, radius, ignore, [ ignoreTeam ]( gentity_t *ent ) {
+		return !( ent->flags & FL_NOTARGET ) && ent->client && ent->client->pers.team != ignoreTeam;
+	}, targets );
+
+	G_SplashVisibility( origin, targets, numTargets );
+
+	for ( int t = 0; t < numTargets; t++ )
 	{
-		mins[ i ] = origin[ i ] - radius;
-		maxs[ i ] = origin[ i ] + radius;
+		if ( targets[ t ].visible )
+		{
+			hitClient = targets[ t ].ent->entity->Damage(targets[ t ].points, attacker, Vec3::Load(origin),
+			                                             Util::nullopt, DAMAGE_NO_LOCDAMAGE, (meansOfDeath_t)mod);
+		}
 	}
 
-	numListedEntities = trap_EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
+	return hitClient;
+}
 
-	for ( e = 0; e < numListedEntities; e++ )
+bool G_RadiusDamage( vec3_t origin, gentity_t *attacker, float damage,
+                         float radius, gentity_t *ignore, int dflags, int mod, team_t testHit )
+{
+	splashTarget_t targets[ MAX_GENTITIES ];
+	int            numTargets;
+	vec3_t         dir;
+	bool       hitSomething = false;
+
+	if ( radius < 1 )
 	{
-		ent = &g_entities[ entityList[ e ] ];
+		radius = 1;
+	}
 
-		if ( ent == ignore )
-		{
-			continue;
-		}
+	if ( testHit != TEAM_NONE )
+	{
+		numTargets = G_SplashTargets( origin, damage, radius, ignore, [ testHit ]( gentity_t *ent ) {
+			return G_Team( ent ) == testHit && G_Alive( ent );
+		}, targets );
 
-		// find the distance from the edge of the bounding box
-		for ( i = 0; i < 3; i++ )
+		// one visible target is enough, so trace them one at a time
+		for ( int t = 0; t < numTargets; t++ )
 		{
-			if ( origin[ i ] < ent->r.absmin[ i ] )
+			if ( G_CanDamage( targets[ t ].ent, origin ) )
 			{
-				v[ i ] = ent->r.absmin[ i ] - origin[ i ];
-			}
-			else if ( origin[ i ] > ent->r.absmax[ i ] )
-			{
-				v[ i ] = origin[ i ] - ent->r.absmax[ i ];
-			}
-			else
-			{
-				v[ i ] = 0;
+				return true;
 			}
 		}
 
-		dist = VectorLength( v );
+		return false;
+	}
 
-		if ( dist >= radius )
+	numTargets = G_SplashTargets( origin, damage, radius, ignore, []( gentity_t * ) {
+		return true;
+	}, targets );
+
+	G_SplashVisibility( origin, targets, numTargets );
+
+	for ( int t = 0; t < numTargets; t++ )
+	{
+		gentity_t *ent = targets[ t ].ent;
+
+		if ( !targets[ t ].visible )
 		{
 			continue;
 		}
 
-		points = damage * ( 1.0 - dist / radius );
+		VectorSubtract( ent->r.currentOrigin, origin, dir );
+		// push the center of mass higher than the origin so players
+		// get knocked into the air more
+		dir[ 2 ] += 24;
+		VectorNormalize( dir );
+
+		hitSomething = ent->entity->Damage(targets[ t ].points, attacker, Vec3::Load(origin), Vec3::Load(dir),
+		                                   (DAMAGE_NO_LOCDAMAGE | dflags), (meansOfDeath_t)mod);
 
-		if ( G_CanDamage( ent, origin ) )
+		// the explosion may have shaken what it rests on
+		if ( hitSomething )
 		{
-			if ( testHit == TEAM_NONE )
-			{
-				VectorSubtract( ent->r.currentOrigin, origin, dir );
-				// push the center of mass higher than the origin so players
-				// get knocked into the air more
-				dir[ 2 ] += 24;
-				VectorNormalize( dir );
-
-				hitSomething = ent->entity->Damage(points, attacker, Vec3::Load(origin), Vec3::Load(dir),
-				                                   (DAMAGE_NO_LOCDAMAGE | dflags), (meansOfDeath_t)mod);
-			}
-			else if ( G_Team( ent ) == testHit && G_Alive( ent ) )
-			{
-				return true;
-			}
+			G_PhysicsWake( ent );
 		}
 	}
 
@@ -149,6 +149,8 @@ Marks the entity as free
 */
 void G_FreeEntity( gentity_t *entity )
 {
+	G_PhysicsWakeResting( entity );
+	G_PhysicsWake( entity );
 	trap_UnlinkEntity( entity );  // unlink from world
 
 	if ( g_debugEntities.integer > 2 )
@@ -177,6 +179,8 @@ void G_FreeEntity( gentity_t *entity )
 		delete entity->entity;
 	}
 
+	G_UnindexEntityNames( entity );
+
 	memset( entity, 0, sizeof( *entity ) );
 	entity->entity = &emptyEntity;
 	entity->classname = "freent";
@@ -185,6 +189,135 @@ void G_FreeEntity( gentity_t *entity )
 }
 
 
+/*
+=================================================================================
+
+gentity name index
+
+Maps every name and alias, case insensitively, to the entities using it so that
+targets don't have to be searched among all entities. Targets and call targets
+keep a pointer to the list of their name, which stays valid until the next map
+and follows entities as they are spawned, freed or regrouped.
+
+=================================================================================
+*/
+
+struct entityNameList_t
+{
+	std::vector<gentity_t*> entities; // sorted by entity number
+};
+
+static std::unordered_map<std::string, entityNameList_t> entityNameIndex;
+
+void G_ClearEntityNameIndex()
+{
+	entityNameIndex.clear();
+}
+
+static entityNameList_t *G_EntityNameList( const char *name )
+{
+	std::string key = name;
+
+	for ( char &c : key )
+	{
+		c = tolower( c );
+	}
+
+	return &entityNameIndex[ key ];
+}
+
+void G_IndexEntityNames( gentity_t *entity )
+{
+	for ( int i = 0; entity->names[ i ]; i++ )
+	{
+		std::vector<gentity_t*> &entities = G_EntityNameList( entity->names[ i ] )->entities;
+		auto it = std::lower_bound( entities.begin(), entities.end(), entity );
+
+		// aliases may repeat the name
+		if ( it == entities.end() || *it != entity )
+		{
+			entities.insert( it, entity );
+		}
+	}
+}
+
+void G_UnindexEntityNames( gentity_t *entity )
+{
+	for ( int i = 0; i < MAX_ENTITY_ALIASES && entity->names[ i ]; i++ )
+	{
+		std::vector<gentity_t*> &entities = G_EntityNameList( entity->names[ i ] )->entities;
+		auto it = std::lower_bound( entities.begin(), entities.end(), entity );
+
+		if ( it != entities.end() && *it == entity )
+		{
+			entities.erase( it );
+		}
+	}
+}
+
+static entityNameList_t *G_TargetList( gentity_t *self, int targetIndex )
+{
+	if ( !self->targetLists[ targetIndex ] )
+	{
+		self->targetLists[ targetIndex ] = G_EntityNameList( self->targets[ targetIndex ] );
+	}
+
+	return self->targetLists[ targetIndex ];
+}
+
+static entityNameList_t *G_CallEndpointList( gentityCallDefinition_t *definition )
+{
+	if ( !definition->endpoints )
+	{
+		definition->endpoints = G_EntityNameList( definition->name );
+	}
+
+	return definition->endpoints;
+}
+
+/**
+ * resolves the targets and call targets of a spawned entity ahead of their first use
+ */
+void G_ResolveEntityTargets( gentity_t *entity )
+{
+	int i;
+
+	for ( i = 0; i < MAX_ENTITY_TARGETS && entity->targets[ i ]; i++ )
+	{
+		if ( entity->targets[ i ][ 0 ] != '$' )
+		{
+			G_TargetList( entity, i );
+		}
+	}
+
+	for ( i = 0; i < MAX_ENTITY_CALLTARGETS && entity->calltargets[ i ].name; i++ )
+	{
+		if ( entity->calltargets[ i ].name[ 0 ] != '$' )
+		{
+			G_CallEndpointList( &entity->calltargets[ i ] );
+		}
+	}
+}
+
+/**
+ * returns the first entity of the list after previous, or the first one if previous is nullptr
+ */
+static gentity_t *G_NextNamedEntity( const entityNameList_t *list, gentity_t *previous, bool skipDisabled )
+{
+	auto it = previous ? std::upper_bound( list->entities.begin(), list->entities.end(), previous )
+	                   : list->entities.begin();
+
+	for ( ; it != list->entities.end(); ++it )
+	{
+		if ( ( *it )->inuse && ( !skipDisabled || ( *it )->enabled ) )
+		{
+			return *it;
+		}
+	}
+
+	return nullptr;
+}
+
 /*
 =================
 G_NewTempEntity
@@ -598,53 +731,51 @@ gentity_t *G_IterateTargets(gentity_t *entity, int *targetIndex, gentity_t *self
 {
 	gentity_t *possibleTarget = nullptr;
 
-	if (entity)
-		goto cont;
+	if (!entity)
+		*targetIndex = 0;
 
-	for (*targetIndex = 0; self->targets[*targetIndex]; ++(*targetIndex))
+	// entity is the previous result within the current target, if any
+	for (; self->targets[*targetIndex]; ++(*targetIndex), entity = nullptr)
 	{
 		if(self->targets[*targetIndex][0] == '$')
 		{
+			if(entity)
+				continue;
+
 			possibleTarget = G_ResolveEntityKeyword( self, self->targets[*targetIndex] );
 			if(possibleTarget && possibleTarget->enabled)
 				return possibleTarget;
 			return nullptr;
 		}
 
-		for( entity = &g_entities[ MAX_CLIENTS ]; entity < &g_entities[ level.num_entities ]; entity++ )
-		{
-			if ( !entity->inuse || !entity->enabled)
-				continue;
-
-			if( G_MatchesName(entity, self->targets[*targetIndex]) )
-				return entity;
+		entity = G_NextNamedEntity( G_TargetList( self, *targetIndex ), entity, true );
 
-			cont: ;
-		}
+		if(entity)
+			return entity;
 	}
 	return nullptr;
 }
 
 gentity_t *G_IterateCallEndpoints(gentity_t *entity, int *calltargetIndex, gentity_t *self)
 {
-	if (entity)
-		goto cont;
+	if (!entity)
+		*calltargetIndex = 0;
 
-	for (*calltargetIndex = 0; self->calltargets[*calltargetIndex].name; ++(*calltargetIndex))
+	// entity is the previous result within the current call target, if any
+	for (; self->calltargets[*calltargetIndex].name; ++(*calltargetIndex), entity = nullptr)
 	{
 		if(self->calltargets[*calltargetIndex].name[0] == '$')
-			return G_ResolveEntityKeyword( self, self->calltargets[*calltargetIndex].name );
-
-		for( entity = &g_entities[ MAX_CLIENTS ]; entity < &g_entities[ level.num_entities ]; entity++ )
 		{
-			if ( !entity->inuse )
+			if(entity)
 				continue;
 
-			if( G_MatchesName(entity, self->calltargets[*calltargetIndex].name) )
-				return entity;
-
-			cont: ;
+			return G_ResolveEntityKeyword( self, self->calltargets[*calltargetIndex].name );
 		}
+
+		entity = G_NextNamedEntity( G_CallEndpointList( &self->calltargets[*calltargetIndex] ), entity, false );
+
+		if(entity)
+			return entity;
 	}
 	return nullptr;
 }
@@ -988,4 +1119,7 @@ void G_SetOrigin( gentity_t *self, const vec3_t origin )
 
 	VectorCopy( origin, self->r.currentOrigin );
 	VectorCopy( origin, self->s.origin );
+
+	// it has to find its floor again
+	G_PhysicsWake( self );
 }
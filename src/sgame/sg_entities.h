@@ -197,6 +197,9 @@ typedef enum
 
 } gentityCallEvent_t;
 
+// the entities sharing a name, see G_EntityNameList
+struct entityNameList_t;
+
 typedef struct
 {
 	const char *event;
@@ -206,6 +209,8 @@ typedef struct
 
 	char  *action;
 	gentityCallActionType_t actionType;
+
+	entityNameList_t *endpoints; // resolved name, set on first use
 } gentityCallDefinition_t;
 
 typedef struct
@@ -226,6 +231,12 @@ gentity_t  *G_NewEntity();
 gentity_t  *G_NewTempEntity( const vec3_t origin, int event );
 void       G_FreeEntity( gentity_t *e );
 
+//name index
+void       G_ClearEntityNameIndex();
+void       G_IndexEntityNames( gentity_t *entity );
+void       G_UnindexEntityNames( gentity_t *entity );
+void       G_ResolveEntityTargets( gentity_t *entity );
+
 //debug
 const char *etos( const gentity_t *entity );
 void       G_PrintEntityNameList( gentity_t *entity );
@@ -271,11 +282,14 @@ void     G_SpawnEntitiesFromString();
 void     G_SpawnFakeEntities();
 void     G_ReorderCallTargets( gentity_t *ent );
 char     *G_NewString( const char *string );
+char     *G_InternString( const char *string );
+void     G_FreeEntityStrings();
 
 //
 // g_spawn_mover.c
 //
 void G_RunMover( gentity_t *ent );
+bool G_Pushable( const gentity_t *ent );
 void door_trigger_touch( gentity_t *ent, gentity_t *other, trace_t *trace );
 void manualTriggerSpectator( gentity_t *trigger, gentity_t *player );
 
@@ -0,0 +1,327 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2016 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished.  If not, see <http://www.gnu.org/licenses/>.
+
+===========================================================================
+*/
+
+// sg_eventlog.cpp -- binary log of match events for statistics
+
+/*
+The event log is a compact alternative to parsing the text logs. Integers are
+stored as LEB128 varints, signed ones zigzag encoded first, and fractional
+values are stored as fixed point integers.
+
+File:
+  "UVEV", version, map name, start date (strings are a length and bytes)
+  events: type, time since the previous event in ms, fields of the type
+
+Every event type has a fixed list of fields, they must be kept in sync with
+src/utils/eventlog2csv.py. Increment EVENTLOG_VERSION when they change.
+*/
+
+#include "sg_local.h"
+
+#define EVENTLOG_VERSION     1
+#define EVENTLOG_BUFFER_SIZE 16384
+
+enum eventLogType_t
+{
+	// killer, victim, mod, assistant, assistantTeam, victimTeam, victimClass
+	EVENTLOG_KILL,
+
+	// target, source, mod, amount (x10), targetTeam
+	EVENTLOG_DAMAGE,
+
+	// fate, buildable, team, actor (slot + 1), builtBy (slot + 1), momentum (x10), x, y, z
+	EVENTLOG_BUILD,
+
+	// team, reason, source (entity + 1), amount (x100), total (x100)
+	EVENTLOG_MOMENTUM,
+
+	// team, players, bots, momentum (x10), totalBudget, spentBudget
+	EVENTLOG_TEAM
+};
+
+static Cvar::Cvar<bool> g_eventLog( "g_eventLog", "write match events to a binary log in stats/events/", Cvar::NONE, false );
+static Cvar::Cvar<int> g_eventLogTeamFrequency( "g_eventLogTeamFrequency", "seconds between team snapshots in the event log", Cvar::NONE, 10 );
+
+static struct
+{
+	fileHandle_t file;
+	std::string  buffer;
+	int          lastTime;
+	int          nextTeamSnapshot;
+} eventLog;
+
+/*
+======================
+Encoding
+======================
+*/
+
+static void EventLogUnsigned( uint32_t value )
+{
+	while ( value >= 0x80 )
+	{
+		eventLog.buffer += ( char )( ( value & 0x7f ) | 0x80 );
+		value >>= 7;
+	}
+
+	eventLog.buffer += ( char ) value;
+}
+
+static void EventLogSigned( int32_t value )
+{
+	EventLogUnsigned( ( ( uint32_t ) value << 1 ) ^ ( uint32_t )( value >> 31 ) );
+}
+
+static void EventLogFixed( float value, float scale )
+{
+	EventLogSigned( ( int32_t ) roundf( value * scale ) );
+}
+
+static void EventLogString( const char *str )
+{
+	size_t length = strlen( str );
+
+	EventLogUnsigned( length );
+	eventLog.buffer.append( str, length );
+}
+
+static void EventLogFlush()
+{
+	if ( eventLog.file && !eventLog.buffer.empty() )
+	{
+		trap_FS_Write( eventLog.buffer.data(), eventLog.buffer.size(), eventLog.file );
+	}
+
+	eventLog.buffer.clear();
+}
+
+/*
+======================
+EventLogBegin
+
+Starts an event, returns false if the event log is disabled.
+======================
+*/
+static bool EventLogBegin( eventLogType_t type )
+{
+	if ( !eventLog.file )
+	{
+		return false;
+	}
+
+	if ( eventLog.buffer.size() >= EVENTLOG_BUFFER_SIZE )
+	{
+		EventLogFlush();
+	}
+
+	EventLogUnsigned( type );
+	EventLogUnsigned( std::max( 0, level.time - eventLog.lastTime ) );
+	eventLog.lastTime = std::max( eventLog.lastTime, level.time );
+
+	return true;
+}
+
+static team_t EventLogTeam( gentity_t *ent )
+{
+	if ( ent->client )
+	{
+		return ( team_t ) ent->client->pers.team;
+	}
+
+	return ent->s.eType == entityType_t::ET_BUILDABLE ? ent->buildableTeam : TEAM_NONE;
+}
+
+/*
+======================
+Events
+======================
+*/
+
+void G_EventLogKill( gentity_t *self, int killer, int assistant, team_t assistantTeam, meansOfDeath_t mod )
+{
+	if ( !EventLogBegin( EVENTLOG_KILL ) )
+	{
+		return;
+	}
+
+	EventLogUnsigned( killer );
+	EventLogUnsigned( self->s.number );
+	EventLogUnsigned( mod );
+	EventLogUnsigned( assistant );
+	EventLogSigned( assistantTeam );
+	EventLogSigned( EventLogTeam( self ) );
+	EventLogUnsigned( self->client ? self->client->ps.stats[ STAT_CLASS ] : PCL_NONE );
+}
+
+void G_EventLogDamage( gentity_t *target, gentity_t *source, float amount, meansOfDeath_t mod )
+{
+	if ( !EventLogBegin( EVENTLOG_DAMAGE ) )
+	{
+		return;
+	}
+
+	EventLogUnsigned( target->s.number );
+	EventLogUnsigned( source ? source->s.number : ENTITYNUM_WORLD );
+	EventLogUnsigned( mod );
+	EventLogFixed( amount, 10.0f );
+	EventLogSigned( EventLogTeam( target ) );
+}
+
+void G_EventLogBuild( const buildLog_t *log )
+{
+	if ( !EventLogBegin( EVENTLOG_BUILD ) )
+	{
+		return;
+	}
+
+	EventLogUnsigned( log->fate );
+	EventLogUnsigned( log->modelindex );
+	EventLogSigned( log->buildableTeam );
+	EventLogUnsigned( log->actor ? log->actor->slot + 1 : 0 );
+	EventLogUnsigned( log->builtBy ? log->builtBy->slot + 1 : 0 );
+	EventLogFixed( log->momentumEarned, 10.0f );
+	EventLogFixed( log->origin[ 0 ], 1.0f );
+	EventLogFixed( log->origin[ 1 ], 1.0f );
+	EventLogFixed( log->origin[ 2 ], 1.0f );
+}
+
+void G_EventLogMomentum( team_t team, int reason, gentity_t *source, float amount )
+{
+	if ( !EventLogBegin( EVENTLOG_MOMENTUM ) )
+	{
+		return;
+	}
+
+	EventLogSigned( team );
+	EventLogUnsigned( reason );
+	EventLogUnsigned( source ? source->s.number + 1 : 0 );
+	EventLogFixed( amount, 100.0f );
+	EventLogFixed( level.team[ team ].momentum, 100.0f );
+}
+
+static void G_EventLogTeams()
+{
+	for ( int team = TEAM_NONE + 1; team < NUM_TEAMS; team++ )
+	{
+		if ( !EventLogBegin( EVENTLOG_TEAM ) )
+		{
+			return;
+		}
+
+		EventLogSigned( team );
+		EventLogUnsigned( level.team[ team ].numPlayers );
+		EventLogUnsigned( level.team[ team ].numBots );
+		EventLogFixed( level.team[ team ].momentum, 10.0f );
+		EventLogFixed( level.team[ team ].totalBudget, 1.0f );
+		EventLogSigned( level.team[ team ].spentBudget );
+	}
+}
+
+/*
+======================
+G_EventLogInit
+======================
+*/
+void G_EventLogInit()
+{
+	char    filename[ 128 ], mapname[ 64 ];
+	qtime_t qt;
+
+	eventLog.file = 0;
+	eventLog.buffer.clear();
+	eventLog.lastTime = 0;
+	eventLog.nextTeamSnapshot = 0;
+
+	if ( !g_eventLog.Get() )
+	{
+		return;
+	}
+
+	Com_GMTime( &qt );
+	trap_Cvar_VariableStringBuffer( "mapname", mapname, sizeof( mapname ) );
+
+	Com_sprintf( filename, sizeof( filename ),
+	             "stats/events/%04i%02i%02i_%02i%02i%02i_%s.events",
+	             1900 + qt.tm_year, qt.tm_mon + 1, qt.tm_mday,
+	             qt.tm_hour, qt.tm_min, qt.tm_sec,
+	             mapname );
+
+	trap_FS_FOpenFile( filename, &eventLog.file, fsMode_t::FS_WRITE );
+
+	if ( !eventLog.file )
+	{
+		Log::Warn( "Couldn't open event log: %s", filename );
+		return;
+	}
+
+	eventLog.buffer.reserve( EVENTLOG_BUFFER_SIZE + 256 );
+	eventLog.buffer.append( "UVEV", 4 );
+	EventLogUnsigned( EVENTLOG_VERSION );
+	EventLogString( mapname );
+	EventLogString( va( "%04i-%02i-%02i %02i:%02i:%02i",
+	                    1900 + qt.tm_year, qt.tm_mon + 1, qt.tm_mday,
+	                    qt.tm_hour, qt.tm_min, qt.tm_sec ) );
+}
+
+/*
+======================
+G_EventLogFrame
+
+Writes the team snapshots and the events of the frame.
+======================
+*/
+void G_EventLogFrame()
+{
+	if ( !eventLog.file )
+	{
+		return;
+	}
+
+	if ( level.time >= eventLog.nextTeamSnapshot )
+	{
+		G_EventLogTeams();
+		eventLog.nextTeamSnapshot = level.time + std::max( 1, g_eventLogTeamFrequency.Get() ) * 1000;
+	}
+
+	EventLogFlush();
+}
+
+/*
+======================
+G_EventLogShutdown
+======================
+*/
+void G_EventLogShutdown()
+{
+	if ( !eventLog.file )
+	{
+		return;
+	}
+
+	G_EventLogTeams();
+	EventLogFlush();
+
+	trap_FS_FCloseFile( eventLog.file );
+	eventLog.file = 0;
+}
@@ -84,6 +84,7 @@ vmCvar_t           g_mapRestarted;
 vmCvar_t           g_logFile;
 vmCvar_t           g_logGameplayStatsFrequency;
 vmCvar_t           g_logFileSync;
+vmCvar_t           g_logWriteStats;
 vmCvar_t           g_allowVote;
 vmCvar_t           g_voteLimit;
 vmCvar_t           g_extendVotesPercent;
@@ -318,6 +319,7 @@ static cvarTable_t gameCvarTable[] =
 	{ &g_logFile,                     "g_logFile",                     "games.log",                        0,                                               0, false    , nullptr       },
 	{ &g_logGameplayStatsFrequency,   "g_logGameplayStatsFrequency",   "10",                               0,                                               0, false    , nullptr       },
 	{ &g_logFileSync,                 "g_logFileSync",                 "0",                                0,                                               0, false    , nullptr       },
+	{ &g_logWriteStats,               "g_logWriteStats",               "0",                                0,                                               0, false    , nullptr       },
 
 	// maps, layouts & rotation
 	{ &g_currentMapRotation,          "g_currentMapRotation",          "-1",                               0,                                               0, false    , nullptr       },
@@ -436,6 +438,7 @@ static const size_t gameCvarTableSize = ARRAY_LEN( gameCvarTable );
 
 void               CheckExitRules();
 static void        G_LogGameplayStats( int state );
+static void        G_LogFlush();
 
 // state field of G_LogGameplayStats
 enum
@@ -458,57 +461,53 @@ All but the last will have the groupChain field set to the next one
 */
 void G_FindEntityGroups()
 {
+	std::unordered_map<const char*, gentity_t*> masters; // group names are interned
 	gentity_t *masterEntity, *comparedEntity;
-	int       i, j, k;
+	int       i, k;
 	int       groupCount, entityCount;
 
 	groupCount = 0;
 	entityCount = 0;
 
-	for ( i = MAX_CLIENTS, masterEntity = g_entities + i; i < level.num_entities; i++, masterEntity++ )
+	// the first entity of a group is its master
+	for ( i = MAX_CLIENTS, comparedEntity = g_entities + i; i < level.num_entities; i++, comparedEntity++ )
 	{
-		if ( !masterEntity->groupName )
+		if ( !comparedEntity->groupName )
 		{
 			continue;
 		}
 
-		if ( masterEntity->flags & FL_GROUPSLAVE )
+		if ( comparedEntity->flags & FL_GROUPSLAVE )
 		{
 			continue;
 		}
 
-		masterEntity->groupMaster = masterEntity;
-		groupCount++;
+		masterEntity = masters.emplace( comparedEntity->groupName, comparedEntity ).first->second;
 		entityCount++;
 
-		for ( j = i + 1, comparedEntity = masterEntity + 1; j < level.num_entities; j++, comparedEntity++ )
+		if ( masterEntity == comparedEntity )
 		{
-			if ( !comparedEntity->groupName )
-			{
-				continue;
-			}
+			masterEntity->groupMaster = masterEntity;
+			groupCount++;
+			continue;
+		}
 
-			if ( comparedEntity->flags & FL_GROUPSLAVE )
-			{
-				continue;
-			}
+		comparedEntity->groupChain = masterEntity->groupChain;
+		masterEntity->groupChain = comparedEntity;
+		comparedEntity->groupMaster = masterEntity;
+		comparedEntity->flags |= FL_GROUPSLAVE;
 
-			if ( !strcmp( masterEntity->groupName, comparedEntity->groupName ) )
-			{
-				entityCount++;
-				comparedEntity->groupChain = masterEntity->groupChain;
-				masterEntity->groupChain = comparedEntity;
-				comparedEntity->groupMaster = masterEntity;
-				comparedEntity->flags |= FL_GROUPSLAVE;
-
-				// make sure that targets only point at the master
-				for (k = 0; comparedEntity->names[k]; k++)
-				{
-					masterEntity->names[k] = comparedEntity->names[k];
-					comparedEntity->names[k] = nullptr;
-				}
-			}
+		// make sure that targets only point at the master
+		G_UnindexEntityNames( masterEntity );
+		G_UnindexEntityNames( comparedEntity );
+
+		for (k = 0; comparedEntity->names[k]; k++)
+		{
+			masterEntity->names[k] = comparedEntity->names[k];
+			comparedEntity->names[k] = nullptr;
 		}
+
+		G_IndexEntityNames( masterEntity );
 	}
 
 	Log::Notice( "%i groups with %i entities", groupCount, entityCount );
@@ -753,6 +752,8 @@ void G_InitGame( int levelTime, int randomSeed, bool inClient )
 		}
 	}
 
+	G_EventLogInit();
+
 	// initialise whether bot vote kicks are allowed. the map rotation may clear this flag.
 	trap_Cvar_Set( "g_botKickVotesAllowedThisMap", g_botKickVotesAllowed.integer ? "1" : "0" );
 
@@ -779,6 +780,8 @@ void G_InitGame( int levelTime, int randomSeed, bool inClient )
 
 	// initialize all entities for this game
 	memset( g_entities, 0, MAX_GENTITIES * sizeof( g_entities[ 0 ] ) );
+	G_ClearEntityNameIndex();
+	G_InitTriggerGrid();
 	level.gentities = g_entities;
 
 	// initilize special entities so they don't need to be special cased in the CBSE code later on
@@ -945,14 +948,26 @@ void G_ShutdownGame( int /* restart */ )
 	{
 		G_LogPrintf( "ShutdownGame:" );
 		G_LogPrintf( "------------------------------------------------------------" );
-		trap_FS_FCloseFile( level.logFile );
-		level.logFile = 0;
 	}
 
 	// finalize logging of gameplay statistics
 	if ( level.logGameplayFile )
 	{
 		G_LogGameplayStats( LOG_GAMEPLAY_STATS_FOOTER );
+	}
+
+	G_LogFlush();
+	G_EventLogShutdown();
+	G_PmoveRecordStop();
+
+	if ( level.logFile )
+	{
+		trap_FS_FCloseFile( level.logFile );
+		level.logFile = 0;
+	}
+
+	if ( level.logGameplayFile )
+	{
 		trap_FS_FCloseFile( level.logGameplayFile );
 		level.logGameplayFile = 0;
 	}
@@ -968,6 +983,7 @@ void G_ShutdownGame( int /* restart */ )
 
 	G_ShutdownMapRotations();
 	BG_UnloadAllConfigs();
+	G_FreeEntityStrings();
 
 	level.restarted = false;
 	level.surrenderTeam = TEAM_NONE;
@@ -1019,28 +1035,24 @@ PLAYER COUNTING / SCORE SORTING
 =============
 SortRanks
 
+Sorts the connected clients by score. They are usually still sorted from the
+previous call, which an insertion sort goes through in a single pass.
 =============
 */
-int QDECL SortRanks( const void *a, const void *b )
+static void SortRanks()
 {
-	gclient_t *ca, *cb;
-
-	ca = &level.clients[ * ( int * ) a ];
-	cb = &level.clients[ * ( int * ) b ];
-
-	// then sort by score
-	if ( ca->ps.persistant[ PERS_SCORE ] > cb->ps.persistant[ PERS_SCORE ] )
+	for ( int i = 1; i < level.numConnectedClients; i++ )
 	{
-		return -1;
-	}
+		int clientNum = level.sortedClients[ i ];
+		int score = level.clients[ clientNum ].ps.persistant[ PERS_SCORE ];
+		int j;
 
-	if ( ca->ps.persistant[ PERS_SCORE ] < cb->ps.persistant[ PERS_SCORE ] )
-	{
-		return 1;
-	}
-	else
-	{
-		return 0;
+		for ( j = i; j > 0 && level.clients[ level.sortedClients[ j - 1 ] ].ps.persistant[ PERS_SCORE ] < score; j-- )
+		{
+			level.sortedClients[ j ] = level.sortedClients[ j - 1 ];
+		}
+
+		level.sortedClients[ j ] = clientNum;
 	}
 }
 
@@ -1379,111 +1391,249 @@ void G_CalculateAvgPlayers()
 
 /*
 ============
-CalculateRanks
+G_CensusEntry
 
-Recalculates the score ranks of all players
-This will be called on every client connect, begin, disconnect, death,
-and team change.
+What a client counts as in the census.
 ============
 */
-void CalculateRanks()
+static censusEntry_t G_CensusEntry( int clientNum )
 {
-	int  clientNum;
-	int  team;
-	char P[ MAX_CLIENTS + 1 ] = "", B[ MAX_CLIENTS + 1 ] = "";
+	gclient_t     *client = &level.clients[ clientNum ];
+	censusEntry_t entry;
 
-	level.numConnectedClients = 0;
-	level.numPlayingClients   = 0;
-	level.numPlayingPlayers   = 0;
-	level.numPlayingBots      = 0;
-	level.numAliveClients     = 0;
+	memset( &entry, 0, sizeof( entry ) );
 
-	for ( team = TEAM_NONE; team < NUM_TEAMS; team++ )
+	if ( client->pers.connected == CON_DISCONNECTED )
 	{
-		level.team[ team ].numClients      = 0;
-		level.team[ team ].numPlayers      = 0;
-		level.team[ team ].numBots         = 0;
-		level.team[ team ].numAliveClients = 0;
+		return entry;
 	}
 
-	for ( clientNum = 0; clientNum < level.maxclients; clientNum++ )
+	entry.listed = true;
+	entry.team = ( team_t ) client->pers.team;
+	entry.bot = level.gentities[ clientNum ].client == client && ( level.gentities[ clientNum ].r.svFlags & SVF_BOT );
+
+	// clients on a team are "playing"
+	entry.playing = client->pers.connected == CON_CONNECTED && entry.team != TEAM_NONE;
+
+	// clients on a team that don't spectate are "alive"
+	entry.alive = entry.playing && client->sess.spectatorState == SPECTATOR_NOT;
+
+	return entry;
+}
+
+/*
+============
+G_CensusCount
+
+Adds (sign 1) or removes (sign -1) a client from the counts.
+============
+*/
+static void G_CensusCount( const censusEntry_t *entry, int sign )
+{
+	if ( !entry->listed )
+	{
+		return;
+	}
+
+	level.numConnectedClients += sign;
+	level.team[ entry->team ].numClients += sign;
+
+	if ( entry->bot )
 	{
-		P[ clientNum ] = '-';
-		B[ clientNum ] = '-';
+		level.team[ entry->team ].numBots += sign;
+	}
+	else
+	{
+		level.team[ entry->team ].numPlayers += sign;
+	}
 
-		if ( level.clients[ clientNum ].pers.connected != CON_DISCONNECTED )
+	if ( entry->playing )
+	{
+		level.numPlayingClients += sign;
+
+		if ( entry->bot )
 		{
-			bool bot = false;
-			int      entNum;
+			level.numPlayingBots += sign;
+		}
+		else
+		{
+			level.numPlayingPlayers += sign;
 
-			for ( entNum = 0; entNum < level.num_entities; ++entNum)
-			{
-				if ( level.gentities[ clientNum ].client == &level.clients[ clientNum ] )
-				{
-					bot = ( level.gentities[ clientNum ].r.svFlags & SVF_BOT );
-					break;
-				}
-			}
+			// voting code expects level.team[ TEAM_NONE ].numPlayers to be all players, spectating or playing
+			// TODO: Use TEAM_ALL or the latter version for this everywhere
+			level.team[ TEAM_NONE ].numPlayers += sign;
+		}
+	}
 
-			level.sortedClients[ level.numConnectedClients ] = clientNum;
+	if ( entry->alive )
+	{
+		level.numAliveClients += sign;
+		level.team[ entry->team ].numAliveClients += sign;
+	}
+}
 
-			team = level.clients[ clientNum ].pers.team;
-			P[ clientNum ] = ( char ) '0' + team;
+/*
+============
+G_CensusUpdate
 
-			level.numConnectedClients++;
-			level.team[ team ].numClients++;
+Moves a client in the counts and sortedClients if it changed since the last
+update.
+============
+*/
+static void G_CensusUpdate( int clientNum )
+{
+	censusEntry_t *counted = &level.census[ clientNum ];
+	censusEntry_t entry = G_CensusEntry( clientNum );
 
-			if ( bot )
-			{
-				B[ clientNum ] = 'b';
-				level.team[ team ].numBots++;
-			}
-			else
-			{
-				level.team[ team ].numPlayers++;
-			}
+	if ( entry.listed == counted->listed && entry.team == counted->team && entry.bot == counted->bot &&
+	     entry.playing == counted->playing && entry.alive == counted->alive )
+	{
+		return;
+	}
 
-			if ( level.clients[ clientNum ].pers.connected != CON_CONNECTED )
-			{
-				continue;
-			}
+	if ( entry.listed && !counted->listed )
+	{
+		// SortRanks moves it to its place
+		level.sortedClients[ level.numConnectedClients ] = clientNum;
+	}
+	else if ( !entry.listed && counted->listed )
+	{
+		int i;
 
-			// clients on a team are "playing"
-			if ( team != TEAM_NONE )
-			{
-				level.numPlayingClients++;
+		for ( i = 0; level.sortedClients[ i ] != clientNum; i++ );
 
-				if ( bot )
-				{
-					level.numPlayingBots++;
-				}
-				else
-				{
-					level.numPlayingPlayers++;
-				}
+		memmove( &level.sortedClients[ i ], &level.sortedClients[ i + 1 ],
+		         ( level.numConnectedClients - i - 1 ) * sizeof( level.sortedClients[ 0 ] ) );
+	}
 
-				// clients on a team that don't spectate are "alive"
-				if ( level.clients[ clientNum ].sess.spectatorState == SPECTATOR_NOT )
-				{
-					level.numAliveClients++;
-					level.team[ team ].numAliveClients++;
-				}
-			}
+	G_CensusCount( counted, -1 );
+	G_CensusCount( &entry, 1 );
+	*counted = entry;
+}
+
+#ifndef NDEBUG
+/*
+============
+G_CheckCensus
+
+Compares the counts kept up to date by G_CensusUpdate with a full recount.
+============
+*/
+static void G_CheckCensus()
+{
+	struct { int numClients, numPlayers, numBots, numAliveClients; } teams[ NUM_TEAMS ] = {};
+	int  connected = 0, alive = 0, playing = 0, playingPlayers = 0, playingBots = 0;
+	bool listed[ MAX_CLIENTS ] = {};
+
+	for ( int clientNum = 0; clientNum < level.maxclients; clientNum++ )
+	{
+		censusEntry_t entry = G_CensusEntry( clientNum );
+
+		if ( !entry.listed )
+		{
+			continue;
+		}
+
+		listed[ clientNum ] = true;
+		connected++;
+		teams[ entry.team ].numClients++;
+		( entry.bot ? teams[ entry.team ].numBots : teams[ entry.team ].numPlayers )++;
+
+		if ( entry.playing )
+		{
+			playing++;
+			( entry.bot ? playingBots : playingPlayers )++;
+		}
+
+		if ( entry.alive )
+		{
+			alive++;
+			teams[ entry.team ].numAliveClients++;
 		}
 	}
 
-	// voting code expects level.team[ TEAM_NONE ].numPlayers to be all players, spectating or playing
-	// TODO: Use TEAM_ALL or the latter version for this everywhere
-	level.team[ TEAM_NONE ].numPlayers += level.numPlayingPlayers;
+	teams[ TEAM_NONE ].numPlayers += playingPlayers;
 
-	P[ clientNum ] = '\0';
-	trap_Cvar_Set( "P", P );
+	bool ok = connected == level.numConnectedClients && alive == level.numAliveClients &&
+	          playing == level.numPlayingClients && playingPlayers == level.numPlayingPlayers &&
+	          playingBots == level.numPlayingBots;
+
+	for ( int team = TEAM_NONE; team < NUM_TEAMS; team++ )
+	{
+		ok = ok && teams[ team ].numClients == level.team[ team ].numClients &&
+		     teams[ team ].numPlayers == level.team[ team ].numPlayers &&
+		     teams[ team ].numBots == level.team[ team ].numBots &&
+		     teams[ team ].numAliveClients == level.team[ team ].numAliveClients;
+	}
+
+	for ( int i = 0; i < level.numConnectedClients; i++ )
+	{
+		int clientNum = level.sortedClients[ i ];
+
+		ok = ok && listed[ clientNum ];
+		listed[ clientNum ] = false;
+
+		if ( i > 0 )
+		{
+			ok = ok && level.clients[ level.sortedClients[ i - 1 ] ].ps.persistant[ PERS_SCORE ] >=
+			           level.clients[ clientNum ].ps.persistant[ PERS_SCORE ];
+		}
+	}
+
+	if ( !ok )
+	{
+		Log::Warn( "CalculateRanks: the census differs from a recount: %i connected, %i alive, %i playing (recounted %i, %i, %i)",
+		           level.numConnectedClients, level.numAliveClients, level.numPlayingClients,
+		           connected, alive, playing );
+	}
+}
+#endif
+
+/*
+============
+CalculateRanks
 
+Updates the client counts and the score ranks of all players
+This will be called on every client connect, begin, disconnect, death,
+and team change.
+============
+*/
+void CalculateRanks()
+{
+	int  clientNum;
+	char P[ MAX_CLIENTS + 1 ], B[ MAX_CLIENTS + 1 ];
+
+	for ( clientNum = 0; clientNum < level.maxclients; clientNum++ )
+	{
+		const censusEntry_t *entry = &level.census[ clientNum ];
+
+		G_CensusUpdate( clientNum );
+
+		P[ clientNum ] = entry->listed ? ( char ) '0' + entry->team : '-';
+		B[ clientNum ] = entry->listed && entry->bot ? 'b' : '-';
+	}
+
+	P[ clientNum ] = '\0';
 	B[ clientNum ] = '\0';
-	trap_Cvar_Set( "B", B );
 
-	qsort( level.sortedClients, level.numConnectedClients,
-	       sizeof( level.sortedClients[ 0 ] ), SortRanks );
+	// most calls are for score changes, don't set the cvars again for them
+	if ( strcmp( P, level.censusP ) )
+	{
+		trap_Cvar_Set( "P", P );
+		Q_strncpyz( level.censusP, P, sizeof( level.censusP ) );
+	}
+
+	if ( strcmp( B, level.censusB ) )
+	{
+		trap_Cvar_Set( "B", B );
+		Q_strncpyz( level.censusB, B, sizeof( level.censusB ) );
+	}
+
+	SortRanks();
+
+#ifndef NDEBUG
+	G_CheckCensus();
+#endif
 
 	// see if it is time to end the level
 	CheckExitRules();
@@ -1670,7 +1820,7 @@ void ExitLevel()
 	}
 	else if ( G_MapRotationActive() )
 	{
-		G_AdvanceMapRotation( 0 );
+		G_AdvanceMapRotation();
 	}
 	else
 	{
@@ -1743,6 +1893,109 @@ void G_AdminMessage( gentity_t *ent, const char *msg )
 	             msg );
 }
 
+/*
+=================
+Log buffering
+
+Lines written to the log files are accumulated and written once per frame,
+or earlier when a buffer fills up, rather than with one write per line.
+=================
+*/
+
+#define LOG_BUFFER_SIZE 16384
+
+typedef struct
+{
+	fileHandle_t *file;
+	char         data[ LOG_BUFFER_SIZE ];
+	int          length;
+} logBuffer_t;
+
+static logBuffer_t logBuffer = { &level.logFile, {}, 0 };
+static logBuffer_t logGameplayBuffer = { &level.logGameplayFile, {}, 0 };
+
+static struct
+{
+	int time;
+	int bytes;
+	int writes;
+} logWriteStats;
+
+static void G_LogWrite( fileHandle_t f, const char *data, int length )
+{
+	trap_FS_Write( data, length, f );
+
+	logWriteStats.bytes += length;
+	logWriteStats.writes++;
+}
+
+static void G_LogFlushBuffer( logBuffer_t *buffer )
+{
+	if ( buffer->length && *buffer->file )
+	{
+		G_LogWrite( *buffer->file, buffer->data, buffer->length );
+	}
+
+	buffer->length = 0;
+}
+
+static void G_LogAppend( logBuffer_t *buffer, const char *data, int length )
+{
+	if ( !*buffer->file )
+	{
+		return;
+	}
+
+	if ( buffer->length + length > LOG_BUFFER_SIZE )
+	{
+		G_LogFlushBuffer( buffer );
+	}
+
+	if ( length > LOG_BUFFER_SIZE )
+	{
+		G_LogWrite( *buffer->file, data, length );
+		return;
+	}
+
+	memcpy( buffer->data + buffer->length, data, length );
+	buffer->length += length;
+
+	// keep the file up to date for tools following it
+	if ( g_logFileSync.integer )
+	{
+		G_LogFlushBuffer( buffer );
+	}
+}
+
+/*
+=================
+G_LogFlush
+
+Writes the buffered log lines, called at the end of each frame and before
+the log files are closed.
+=================
+*/
+static void G_LogFlush()
+{
+	G_LogFlushBuffer( &logBuffer );
+	G_LogFlushBuffer( &logGameplayBuffer );
+
+	if ( level.time - logWriteStats.time < 60000 && level.time >= logWriteStats.time )
+	{
+		return;
+	}
+
+	if ( g_logWriteStats.integer )
+	{
+		Log::Notice( "log files: %d bytes in %d writes over the last minute",
+		             logWriteStats.bytes, logWriteStats.writes );
+	}
+
+	logWriteStats.time = level.time;
+	logWriteStats.bytes = 0;
+	logWriteStats.writes = 0;
+}
+
 /*
 =================
 G_LogPrintf
@@ -1785,8 +2038,8 @@ void QDECL PRINTF_LIKE(1) G_LogPrintf( const char *fmt, ... )
 	}
 
 	Color::StripColors( string, decolored, sizeof( decolored ) );
-	trap_FS_Write( decolored, strlen( decolored ), level.logFile );
-    trap_FS_Write( "\n", 1, level.logFile );
+	G_LogAppend( &logBuffer, decolored, strlen( decolored ) );
+	G_LogAppend( &logBuffer, "\n", 1 );
 }
 
 /*
@@ -1974,7 +2227,7 @@ static void G_LogGameplayStats( int state )
 			return;
 	}
 
-	trap_FS_Write( logline, strlen( logline ), level.logGameplayFile );
+	G_LogAppend( &logGameplayBuffer, logline, strlen( logline ) );
 
 	if ( state == LOG_GAMEPLAY_STATS_BODY )
 	{
@@ -2923,6 +3176,10 @@ void G_RunFrame( int levelTime )
 	}
 
 	trap_BotUpdateObstacles();
+
+	G_LogFlush();
+	G_EventLogFrame();
+
 	level.frameMsec = trap_Milliseconds();
 }
 
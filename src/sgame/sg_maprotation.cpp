@@ -95,13 +95,42 @@ typedef struct rotationNode_s
 	} u;
 } mrNode_t;
 
+/*
+The parsed nodes are compiled into one program for all the rotations, which is
+what G_AdvanceMapRotation runs. Conditions become conditional jumps, and goto
+and resume are resolved to a jump or a rotation switch once instead of looking
+the name up every time.
+*/
+typedef enum
+{
+  MR_MAP,      // change to the map and stop
+  MR_IF,       // go on if the condition holds, jump to target otherwise
+  MR_JUMP,     // continue at target
+  MR_ROTATION, // switch to rotation target and continue at its current node
+  MR_RETURN    // switch back to the rotation on the stack
+} mrOpcode_t;
+
+typedef struct mrInstruction_s
+{
+	mrOpcode_t op;
+	int        rotation; // rotation and node it was compiled from
+	int        node;
+	int        target;   // instruction for MR_IF and MR_JUMP, rotation for MR_ROTATION
+	bool       reset;    // MR_ROTATION: start the rotation over (goto) instead of resuming it
+
+	const mrMapDescription_t *map;
+	const mrCondition_t      *condition;
+} mrInstruction_t;
+
 typedef struct mapRotation_s
 {
 	char   name[ MAX_QPATH ];
 
 	mrNode_t *nodes[ MAX_MAP_ROTATION_MAPS ];
 	int      numNodes;
-	int      currentNode;
+	int      currentNode; // the node to start from next time, saved in g_mapRotationNodes
+
+	int      entry[ MAX_MAP_ROTATION_MAPS + 1 ]; // first instruction of every node, then of the jump back to the start
 } mapRotation_t;
 
 typedef struct mapRotations_s
@@ -110,10 +139,11 @@ typedef struct mapRotations_s
 	int           numRotations;
 } mapRotations_t;
 
-static mapRotations_t mapRotations;
+static mapRotations_t               mapRotations;
+static std::vector<mrInstruction_t> mapRotationProgram;
 
-static int            G_CurrentNodeIndex( int rotation );
 static int            G_NodeIndexAfter( int currentNode, int rotation );
+void                  G_FreeNode( mrNode_t *node );
 
 /*
 ===============
@@ -490,17 +520,54 @@ static bool G_ParseMapRotation( mapRotation_t *mr, const char **text_p )
 	return false;
 }
 
+/*
+===============
+G_FreeMapRotation
+
+Free the nodes of a map rotation and clear it
+===============
+*/
+static void G_FreeMapRotation( mapRotation_t *mr )
+{
+	for ( int i = 0; i < mr->numNodes; i++ )
+	{
+		G_FreeNode( mr->nodes[ i ] );
+	}
+
+	memset( mr, 0, sizeof( *mr ) );
+}
+
+/*
+===============
+G_DropMapRotation
+
+Remove a map rotation that failed to validate, keeping the others in order
+===============
+*/
+static void G_DropMapRotation( int rotation )
+{
+	mapRotation_t *mr = &mapRotations.rotations[ rotation ];
+
+	Log::Warn( "map rotation %s is not used", mr->name );
+
+	G_FreeMapRotation( mr );
+	memmove( mr, mr + 1, ( mapRotations.numRotations - rotation - 1 ) * sizeof( *mr ) );
+
+	mapRotations.numRotations--;
+	memset( &mapRotations.rotations[ mapRotations.numRotations ], 0, sizeof( *mr ) );
+}
+
 /*
 ===============
 G_ParseMapRotationFile
 
-Load the map rotations from a map rotation file
+Load the map rotations from a map rotation file, the ones parsed before an
+error are kept
 ===============
 */
 static bool G_ParseMapRotationFile( const char *fileName )
 {
 	const char *text_p;
-	int          i, j;
 	int          len;
 	char         *token;
 	char         text[ 20000 ];
@@ -564,6 +631,7 @@ static bool G_ParseMapRotationFile( const char *fileName )
 				if ( !G_ParseMapRotation( &mapRotations.rotations[ mapRotations.numRotations ], &text_p ) )
 				{
 					Log::Warn("%s: failed to parse map rotation %s", fileName, mrName );
+					G_FreeMapRotation( &mapRotations.rotations[ mapRotations.numRotations ] );
 					return false;
 				}
 
@@ -593,63 +661,482 @@ static bool G_ParseMapRotationFile( const char *fileName )
 		}
 	}
 
+	return true;
+}
+
+/*
+===============
+G_ValidateMapRotation
+
+Check that the maps and the destinations of a parsed map rotation exist
+===============
+*/
+static bool G_ValidateMapRotation( int rotation )
+{
+	mapRotation_t *mr = &mapRotations.rotations[ rotation ];
+	int           mapCount = 0;
+
+	for ( int i = 0; i < mr->numNodes; i++ )
+	{
+		mrNode_t *node = mr->nodes[ i ];
+
+		if ( node->type == NT_MAP )
+		{
+			mapCount++;
+
+			if ( !G_MapExists( node->u.map.name ) )
+			{
+				Log::Warn("rotation map \"%s\" doesn't exist",
+				          node->u.map.name );
+				return false;
+			}
+
+			continue;
+		}
+		else if ( node->type == NT_RETURN )
+		{
+			continue;
+		}
+		else if ( node->type == NT_LABEL )
+		{
+			continue;
+		}
+		else
+		{
+			while ( node->type == NT_CONDITION )
+			{
+				node = node->u.condition.target;
+			}
+		}
+
+		if ( ( node->type == NT_GOTO || node->type == NT_RESUME ) &&
+		     !G_LabelExists( rotation, node->u.label.name ) &&
+		     !G_RotationExists( node->u.label.name ) )
+		{
+			Log::Warn("goto destination named \"%s\" doesn't exist",
+			          node->u.label.name );
+			return false;
+		}
+	}
+
+	if ( mapCount == 0 )
+	{
+		Log::Warn("rotation \"%s\" needs at least one map entry",
+		          mr->name );
+		return false;
+	}
+
+	return true;
+}
+
+/*
+===============
+G_ValidateMapRotations
+
+Drop the parsed map rotations that fail to validate, and then the ones
+going to them
+===============
+*/
+static bool G_ValidateMapRotations()
+{
+	bool valid = true;
+	int  i = 0;
+
+	while ( i < mapRotations.numRotations )
+	{
+		if ( G_ValidateMapRotation( i ) )
+		{
+			i++;
+			continue;
+		}
+
+		G_DropMapRotation( i );
+		valid = false;
+		i = 0;
+	}
+
+	return valid;
+}
+
+/*
+===============
+G_RotationIndex
+
+Returns the index of a rotation by its name, -1 if there is none
+===============
+*/
+static int G_RotationIndex( const char *name )
+{
+	int i;
+
 	for ( i = 0; i < mapRotations.numRotations; i++ )
 	{
-		mapRotation_t *mr = &mapRotations.rotations[ i ];
-		int           mapCount = 0;
+		if ( !Q_stricmp( mapRotations.rotations[ i ].name, name ) )
+		{
+			return i;
+		}
+	}
 
-		for ( j = 0; j < mr->numNodes; j++ )
+	return -1;
+}
+
+/*
+===============
+G_CompileNode
+
+Append the instructions of a node to the program. Jump targets are node
+indices until G_CompileMapRotations resolves them.
+===============
+*/
+static bool G_CompileNode( int rotation, int nodeIndex )
+{
+	mapRotation_t   *mr = &mapRotations.rotations[ rotation ];
+	mrNode_t        *node = mr->nodes[ nodeIndex ];
+	mrInstruction_t instruction;
+
+	memset( &instruction, 0, sizeof( instruction ) );
+	instruction.rotation = rotation;
+	instruction.node = nodeIndex;
+
+	// every condition of the chain skips to the next node when it fails
+	while ( node->type == NT_CONDITION )
+	{
+		instruction.op = MR_IF;
+		instruction.condition = &node->u.condition;
+		instruction.target = nodeIndex + 1;
+		mapRotationProgram.push_back( instruction );
+
+		node = node->u.condition.target;
+	}
+
+	instruction.condition = nullptr;
+	instruction.target = 0;
+
+	switch ( node->type )
+	{
+		case NT_MAP:
+			instruction.op = MR_MAP;
+			instruction.map = &node->u.map;
+			break;
+
+		case NT_LABEL:
+			return true;
+
+		case NT_RETURN:
+			instruction.op = MR_RETURN;
+			break;
+
+		case NT_GOTO:
+		case NT_RESUME:
 		{
-			mrNode_t *node = mr->nodes[ j ];
+			const char *name = node->u.label.name;
+			int        i;
+
+			// rotation names come first...
+			instruction.target = G_RotationIndex( name );
 
-			if ( node->type == NT_MAP )
+			if ( instruction.target >= 0 )
 			{
-				mapCount++;
+				instruction.op = MR_ROTATION;
+				instruction.reset = node->type == NT_GOTO;
+				break;
+			}
+
+			// ...then the labels of the rotation, going on after the label...
+			instruction.op = MR_JUMP;
 
-				if ( !G_MapExists( node->u.map.name ) )
+			for ( i = 0; i < mr->numNodes; i++ )
+			{
+				if ( mr->nodes[ i ]->type == NT_LABEL && !Q_stricmp( mr->nodes[ i ]->u.label.name, name ) )
 				{
-					Log::Warn("rotation map \"%s\" doesn't exist",
-					          node->u.map.name );
-					return false;
+					instruction.target = G_NodeIndexAfter( i, rotation );
+					break;
 				}
+			}
 
-				continue;
+			if ( i < mr->numNodes )
+			{
+				break;
 			}
-			else if ( node->type == NT_RETURN )
+
+			// ...and finally the next map by that name
+			for ( i = 1; i <= mr->numNodes; i++ )
 			{
+				int target = ( nodeIndex + i ) % mr->numNodes;
+
+				if ( mr->nodes[ target ]->type == NT_MAP && !Q_stricmp( mr->nodes[ target ]->u.map.name, name ) )
+				{
+					instruction.target = target;
+					break;
+				}
+			}
+
+			if ( i > mr->numNodes )
+			{
+				Log::Warn( "label, map, or rotation %s not found in %s", name, mr->name );
+				return false;
+			}
+
+			break;
+		}
+
+		default:
+			Log::Warn( "malformed node %i in map rotation %s", nodeIndex, mr->name );
+			return false;
+	}
+
+	mapRotationProgram.push_back( instruction );
+
+	return true;
+}
+
+/*
+===============
+G_FindMapRotationLoop
+
+Depth first search for a cycle among the instructions, leaving out the
+conditions if skipConditions is set. Returns the instruction the cycle was
+found at, -1 if there is none.
+===============
+*/
+static int G_FindMapRotationLoop( const std::vector<std::vector<int>> &successors, bool skipConditions )
+{
+	enum { UNVISITED, VISITING, DONE };
+
+	int                              size = successors.size();
+	std::vector<int>                 state( size, UNVISITED );
+	std::vector<std::pair<int, int>> stack; // instruction, next successor to visit
+
+	for ( int start = 0; start < size; start++ )
+	{
+		if ( state[ start ] != UNVISITED ||
+		     ( skipConditions && mapRotationProgram[ start ].op == MR_IF ) )
+		{
+			continue;
+		}
+
+		state[ start ] = VISITING;
+		stack.emplace_back( start, 0 );
+
+		while ( !stack.empty() )
+		{
+			int pc = stack.back().first;
+
+			if ( stack.back().second == ( int ) successors[ pc ].size() )
+			{
+				state[ pc ] = DONE;
+				stack.pop_back();
 				continue;
 			}
-			else if ( node->type == NT_LABEL )
+
+			int next = successors[ pc ][ stack.back().second++ ];
+
+			if ( skipConditions && mapRotationProgram[ next ].op == MR_IF )
 			{
 				continue;
 			}
-			else
+
+			if ( state[ next ] == VISITING )
 			{
-				while ( node->type == NT_CONDITION )
+				return next;
+			}
+
+			if ( state[ next ] == UNVISITED )
+			{
+				state[ next ] = VISITING;
+				stack.emplace_back( next, 0 );
+			}
+		}
+	}
+
+	return -1;
+}
+
+/*
+===============
+G_CheckMapRotationLoops
+
+Look for instructions that can run again before a map is chosen. A loop
+without conditions would keep G_AdvanceMapRotation looping forever, the
+rotation it is found in is returned, -1 if there is none. A loop through
+conditions only runs as long as they allow, like a rotation choosing between
+others on the number of clients, so it is only reported and left to the step
+limit of G_AdvanceMapRotation.
+===============
+*/
+static int G_CheckMapRotationLoops()
+{
+	int                           size = mapRotationProgram.size();
+	std::vector<std::vector<int>> successors( size );
+	std::vector<int>              resumes[ MAX_MAP_ROTATIONS ], returns;
+	bool                          pushed[ MAX_MAP_ROTATIONS ] = { false };
+	int                           pc;
+
+	// A loop has to leave every rotation it resumes or returns to before getting back to it,
+	// which advances the current node of that rotation past the switch or the return. So within
+	// a loop, a rotation only goes on after one of those: the node after a map, where an
+	// earlier map change left it, can't come up again. Returns only go to rotations that
+	// switch to another one, as that puts them on the stack.
+	for ( const mrInstruction_t &instruction : mapRotationProgram )
+	{
+		const mapRotation_t *mr = &mapRotations.rotations[ instruction.rotation ];
+		int                 after = mr->entry[ G_NodeIndexAfter( instruction.node, instruction.rotation ) ];
+
+		if ( instruction.op == MR_ROTATION || instruction.op == MR_RETURN )
+		{
+			resumes[ instruction.rotation ].push_back( after );
+		}
+
+		if ( instruction.op == MR_ROTATION )
+		{
+			pushed[ instruction.rotation ] = true;
+		}
+	}
+
+	for ( int rotation = 0; rotation < mapRotations.numRotations; rotation++ )
+	{
+		if ( pushed[ rotation ] )
+		{
+			returns.insert( returns.end(), resumes[ rotation ].begin(), resumes[ rotation ].end() );
+		}
+	}
+
+	for ( pc = 0; pc < size; pc++ )
+	{
+		const mrInstruction_t *instruction = &mapRotationProgram[ pc ];
+
+		switch ( instruction->op )
+		{
+			case MR_MAP:
+				break;
+
+			case MR_IF:
+				successors[ pc ] = { pc + 1, instruction->target };
+				break;
+
+			case MR_JUMP:
+				successors[ pc ] = { instruction->target };
+				break;
+
+			case MR_ROTATION:
+				if ( instruction->reset )
 				{
-					node = node->u.condition.target;
+					successors[ pc ] = { mapRotations.rotations[ instruction->target ].entry[ 0 ] };
 				}
-			}
+				else
+				{
+					successors[ pc ] = resumes[ instruction->target ];
+				}
+
+				break;
+
+			case MR_RETURN:
+				// pc + 1 when there is nothing on the stack
+				successors[ pc ] = returns;
+				successors[ pc ].push_back( pc + 1 );
+				break;
+		}
+	}
+
+	pc = G_FindMapRotationLoop( successors, true );
+
+	if ( pc >= 0 )
+	{
+		const mrInstruction_t *instruction = &mapRotationProgram[ pc ];
+
+		Log::Warn( "map rotation %s loops forever without changing map at node %i",
+		           mapRotations.rotations[ instruction->rotation ].name, instruction->node + 1 );
+		return instruction->rotation;
+	}
+
+	pc = G_FindMapRotationLoop( successors, false );
+
+	if ( pc >= 0 )
+	{
+		const mrInstruction_t *instruction = &mapRotationProgram[ pc ];
+
+		Log::Warn( "map rotation %s can loop without changing map at node %i for as long as its conditions allow",
+		           mapRotations.rotations[ instruction->rotation ].name, instruction->node + 1 );
+	}
+
+	return -1;
+}
+
+/*
+===============
+G_CompileMapRotationProgram
+
+Compile the parsed map rotations into mapRotationProgram. Returns the rotation
+that failed to compile, -1 if all of them did.
+===============
+*/
+static int G_CompileMapRotationProgram()
+{
+	int i, j;
+
+	mapRotationProgram.clear();
+
+	for ( i = 0; i < mapRotations.numRotations; i++ )
+	{
+		mapRotation_t *mr = &mapRotations.rotations[ i ];
+		size_t        first = mapRotationProgram.size();
+
+		for ( j = 0; j < mr->numNodes; j++ )
+		{
+			mr->entry[ j ] = mapRotationProgram.size();
 
-			if ( ( node->type == NT_GOTO || node->type == NT_RESUME ) &&
-			     !G_LabelExists( i, node->u.label.name ) &&
-			     !G_RotationExists( node->u.label.name ) )
+			if ( !G_CompileNode( i, j ) )
 			{
-				Log::Warn("goto destination named \"%s\" doesn't exist",
-				          node->u.label.name );
-				return false;
+				return i;
 			}
 		}
 
-		if ( mapCount == 0 )
+		// the last node goes on with the first one
+		mrInstruction_t wrap;
+
+		memset( &wrap, 0, sizeof( wrap ) );
+		wrap.op = MR_JUMP;
+		wrap.rotation = i;
+		wrap.node = mr->numNodes - 1;
+		wrap.target = 0;
+
+		mr->entry[ mr->numNodes ] = mapRotationProgram.size();
+		mapRotationProgram.push_back( wrap );
+
+		// the targets are known now
+		for ( size_t pc = first; pc < mapRotationProgram.size(); pc++ )
 		{
-			Log::Warn("rotation \"%s\" needs at least one map entry",
-			          mr->name );
-			return false;
+			mrInstruction_t *instruction = &mapRotationProgram[ pc ];
+
+			if ( instruction->op == MR_IF || instruction->op == MR_JUMP )
+			{
+				instruction->target = mr->entry[ instruction->target ];
+			}
 		}
 	}
 
-	return true;
+	return G_CheckMapRotationLoops();
+}
+
+/*
+===============
+G_CompileMapRotations
+
+Compile the map rotations, dropping the ones that fail until the others do
+===============
+*/
+static bool G_CompileMapRotations()
+{
+	bool compiled = true;
+	int  rotation;
+
+	while ( ( rotation = G_CompileMapRotationProgram() ) >= 0 )
+	{
+		G_DropMapRotation( rotation );
+		compiled = false;
+	}
+
+	return compiled;
 }
 
 // Some constants for map rotation listing
@@ -758,6 +1245,8 @@ void G_PrintRotations()
 		Log::Notice( MAP_DEFAULT "}" );
 	}
 
+	size += mapRotationProgram.size() * sizeof( mrInstruction_t );
+
 	Log::Notice( "Total memory used: %d bytes", size );
 }
 
@@ -805,7 +1294,7 @@ void G_PrintCurrentRotation( gentity_t *ent )
 		{
 			colour = MAP_BAD;
 		}
-		else if ( G_NodeIndexAfter( i - 1, mapRotationIndex ) == G_CurrentNodeIndex( mapRotationIndex ) )
+		else if ( G_NodeIndexAfter( i - 1, mapRotationIndex ) == mapRotation->currentNode )
 		{
 			currentMap = true;
 			currentShown = node->type == NT_MAP;
@@ -945,23 +1434,23 @@ static char *G_RotationNameByIndex( int index )
 
 /*
 ===============
-G_CurrentNodeIndexArray
+G_LoadCurrentNodes
 
-Fill a static array with the current node of each rotation
+Read the current node of each rotation, saved in g_mapRotationNodes across map
+changes
 ===============
 */
-static int *G_CurrentNodeIndexArray()
+static void G_LoadCurrentNodes()
 {
-	static int currentNode[ MAX_MAP_ROTATIONS ];
-	int        i = 0;
-	char       text[ MAX_MAP_ROTATIONS * 2 ];
-	const char       *text_p, *token;
+	int  i = 0;
+	char text[ MAX_CVAR_VALUE_STRING ];
+	const char *text_p, *token;
 
 	Q_strncpyz( text, g_mapRotationNodes.string, sizeof( text ) );
 
 	text_p = text;
 
-	while ( 1 )
+	while ( i < mapRotations.numRotations )
 	{
 		token = COM_Parse( &text_p );
 
@@ -970,10 +1459,8 @@ static int *G_CurrentNodeIndexArray()
 			break;
 		}
 
-		currentNode[ i++ ] = atoi( token );
+		mapRotations.rotations[ i++ ].currentNode = atoi( token );
 	}
-
-	return currentNode;
 }
 
 /*
@@ -986,14 +1473,13 @@ Set the current map in some rotation
 static void G_SetCurrentNodeByIndex( int currentNode, int rotation )
 {
 	char text[ MAX_MAP_ROTATIONS * 4 ] = { 0 };
-	int  *p = G_CurrentNodeIndexArray();
 	int  i;
 
-	p[ rotation ] = currentNode;
+	mapRotations.rotations[ rotation ].currentNode = currentNode;
 
 	for ( i = 0; i < mapRotations.numRotations; i++ )
 	{
-		Q_strcat( text, sizeof( text ), va( "%d ", p[ i ] ) );
+		Q_strcat( text, sizeof( text ), va( "%d ", mapRotations.rotations[ i ].currentNode ) );
 	}
 
 	trap_Cvar_Set( "g_mapRotationNodes", text );
@@ -1002,34 +1488,33 @@ static void G_SetCurrentNodeByIndex( int currentNode, int rotation )
 
 /*
 ===============
-G_CurrentNodeIndex
-
-Return the current node index in some rotation
+G_SetCurrentRotation
 ===============
 */
-static int G_CurrentNodeIndex( int rotation )
+static void G_SetCurrentRotation( int rotation )
 {
-	int *p = G_CurrentNodeIndexArray();
-
-	return p[ rotation ];
+	trap_Cvar_Set( "g_currentMapRotation", va( "%d", rotation ) );
+	trap_Cvar_Update( &g_currentMapRotation );
 }
 
 /*
 ===============
-G_NodeByIndex
+G_CurrentInstruction
 
-Return a node in a rotation by its index
+Return the instruction the current node of a rotation starts at
 ===============
 */
-static mrNode_t *G_NodeByIndex( int index, int rotation )
+static int G_CurrentInstruction( int rotation )
 {
-	if ( rotation >= 0 && rotation < mapRotations.numRotations &&
-	     index >= 0 && index < mapRotations.rotations[ rotation ].numNodes )
+	mapRotation_t *mr = &mapRotations.rotations[ rotation ];
+
+	if ( mr->currentNode < 0 || mr->currentNode >= mr->numNodes )
 	{
-		return mapRotations.rotations[ rotation ].nodes[ index ];
+		Log::Warn( "index incorrect for map rotation %s, trying 0", mr->name );
+		mr->currentNode = 0;
 	}
 
-	return nullptr;
+	return mr->entry[ mr->currentNode ];
 }
 
 /*
@@ -1039,10 +1524,8 @@ G_IssueMapChange
 Send commands to the server to actually change the map
 ===============
 */
-static void G_IssueMapChange( int index, int rotation )
+static void G_IssueMapChange( const mrMapDescription_t *map )
 {
-	mrNode_t *node = mapRotations.rotations[ rotation ].nodes[ index ];
-	mrMapDescription_t  *map = &node->u.map;
 	char currentMapName[ MAX_STRING_CHARS ];
 
 	trap_Cvar_VariableStringBuffer( "mapname", currentMapName, sizeof( currentMapName ) );
@@ -1083,55 +1566,6 @@ static void G_IssueMapChange( int index, int rotation )
 	}
 }
 
-/*
-===============
-G_GotoLabel
-
-Resolve the label of some condition
-===============
-*/
-static bool G_GotoLabel( int rotation, int nodeIndex, char *name,
-                             bool reset_index, int depth )
-{
-	mrNode_t *node;
-	int    i;
-
-	// Search the rotation names...
-	if ( G_StartMapRotation( name, true, true, reset_index, depth ) )
-	{
-		return true;
-	}
-
-	// ...then try labels in the rotation
-	for ( i = 0; i < mapRotations.rotations[ rotation ].numNodes; i++ )
-	{
-		node = mapRotations.rotations[ rotation ].nodes[ i ];
-
-		if ( node->type == NT_LABEL && !Q_stricmp( node->u.label.name, name ) )
-		{
-			G_SetCurrentNodeByIndex( G_NodeIndexAfter( i, rotation ), rotation );
-			G_AdvanceMapRotation( depth );
-			return true;
-		}
-	}
-
-	// finally check for a map by name
-	for ( i = 0; i < mapRotations.rotations[ rotation ].numNodes; i++ )
-	{
-		nodeIndex = G_NodeIndexAfter( nodeIndex, rotation );
-		node = mapRotations.rotations[ rotation ].nodes[ nodeIndex ];
-
-		if ( node->type == NT_MAP && !Q_stricmp( node->u.map.name, name ) )
-		{
-			G_SetCurrentNodeByIndex( nodeIndex, rotation );
-			G_AdvanceMapRotation( depth );
-			return true;
-		}
-	}
-
-	return false;
-}
-
 /*
 ===============
 G_EvaluateMapCondition
@@ -1139,52 +1573,44 @@ G_EvaluateMapCondition
 Evaluate a map condition
 ===============
 */
-static bool G_EvaluateMapCondition( mrCondition_t **condition )
+static bool G_EvaluateMapCondition( const mrCondition_t *condition )
 {
-	bool    result = false;
-	mrCondition_t *localCondition = *condition;
+	bool result = false;
 
-	switch ( localCondition->lhs )
+	switch ( condition->lhs )
 	{
 		case CV_RANDOM:
 			result = rand() / ( RAND_MAX / 2 + 1 );
 			break;
 
 		case CV_NUMCLIENTS:
-			switch ( localCondition->operator_ )
+			switch ( condition->operator_ )
 			{
 				case CO_LT:
-					result = level.numConnectedClients < localCondition->numClients;
+					result = level.numConnectedClients < condition->numClients;
 					break;
 
 				case CO_GT:
-					result = level.numConnectedClients > localCondition->numClients;
+					result = level.numConnectedClients > condition->numClients;
 					break;
 
 				case CO_EQ:
-					result = level.numConnectedClients == localCondition->numClients;
+					result = level.numConnectedClients == condition->numClients;
 					break;
 			}
 
 			break;
 
 		case CV_LASTWIN:
-			result = level.lastWin == localCondition->lastWin;
+			result = level.lastWin == condition->lastWin;
 			break;
 
 		default:
 		case CV_ERR:
-			Log::Warn("malformed map switch localCondition" );
+			Log::Warn("malformed map switch condition" );
 			break;
 	}
 
-	if ( localCondition->target->type == NT_CONDITION )
-	{
-		*condition = &localCondition->target->u.condition;
-
-		return result && G_EvaluateMapCondition( condition );
-	}
-
 	return result;
 }
 
@@ -1202,155 +1628,113 @@ static int G_NodeIndexAfter( int currentNode, int rotation )
 
 /*
 ===============
-G_StepMapRotation
+G_AdvanceMapRotation
 
-Run one node of a map rotation
+Run the current map rotation until it changes map
 ===============
 */
-bool G_StepMapRotation( int rotation, int nodeIndex, int depth )
+void G_AdvanceMapRotation()
 {
-	mrNode_t      *node;
-	mrCondition_t *condition;
-	int         returnRotation;
-	bool    step = true;
+	int rotation, pc, steps;
 
-	node = G_NodeByIndex( nodeIndex, rotation );
-	depth++;
+	rotation = g_currentMapRotation.integer;
 
-	// guard against inifinite loop in conditional code
-	if ( depth > 32 && node->type != NT_MAP )
+	if ( rotation < 0 || rotation >= MAX_MAP_ROTATIONS )
 	{
-		if ( depth > 64 )
-		{
-			Log::Warn("infinite loop protection stopped at map rotation %s",
-			          G_RotationNameByIndex( rotation ) );
-			return false;
-		}
-
-		Log::Warn("possible infinite loop in map rotation %s",
-		          G_RotationNameByIndex( rotation ) );
-		return true;
+		return;
 	}
 
-	while ( step )
+	if ( rotation >= mapRotations.numRotations )
 	{
-		step = false;
-
-		switch ( node->type )
-		{
-			case NT_CONDITION:
-				condition = &node->u.condition;
-
-				if ( G_EvaluateMapCondition( &condition ) )
-				{
-					node = condition->target;
-					step = true;
-					continue;
-				}
-
-				break;
+		Log::Warn( "no map rotation with index %d", rotation );
+		return;
+	}
 
-			case NT_RETURN:
-				returnRotation = G_PopRotationStack();
+	pc = G_CurrentInstruction( rotation );
 
-				if ( returnRotation >= 0 )
-				{
-					G_SetCurrentNodeByIndex(
-					  G_NodeIndexAfter( nodeIndex, rotation ), rotation );
+	// G_CompileMapRotations made sure that no instruction runs twice before a map is chosen,
+	// unless a map was removed since or the stack was left by an earlier rotation file, or
+	// in between a rotation was resumed where an earlier map change left it, which only
+	// happens once per rotation
+	steps = mapRotationProgram.size() * ( mapRotations.numRotations + 1 );
 
-					if ( G_StartMapRotation( G_RotationNameByIndex( returnRotation ),
-					                         true, false, false, depth ) )
-					{
-						return false;
-					}
-				}
-
-				break;
+	while ( steps-- > 0 )
+	{
+		const mrInstruction_t *instruction = &mapRotationProgram[ pc ];
+		int                   returnRotation;
 
-			case NT_MAP:
-				if ( G_MapExists( node->u.map.name ) )
+		switch ( instruction->op )
+		{
+			case MR_MAP:
+				if ( G_MapExists( instruction->map->name ) )
 				{
 					G_SetCurrentNodeByIndex(
-					  G_NodeIndexAfter( nodeIndex, rotation ), rotation );
+					  G_NodeIndexAfter( instruction->node, rotation ), rotation );
 
 					if ( !G_MapExists( g_nextMap.string ) )
 					{
-						G_IssueMapChange( nodeIndex, rotation );
+						G_IssueMapChange( instruction->map );
 					}
 
-					return false;
+					return;
 				}
 
 				Log::Warn("skipped missing map %s in rotation %s",
-				          node->u.map.name, G_RotationNameByIndex( rotation ) );
+				          instruction->map->name, G_RotationNameByIndex( rotation ) );
+				pc++;
 				break;
 
-			case NT_LABEL:
+			case MR_IF:
+				pc = G_EvaluateMapCondition( instruction->condition ) ? pc + 1 : instruction->target;
 				break;
 
-			case NT_GOTO:
-			case NT_RESUME:
+			case MR_JUMP:
+				pc = instruction->target;
+				break;
+
+			case MR_ROTATION:
 				G_SetCurrentNodeByIndex(
-				  G_NodeIndexAfter( nodeIndex, rotation ), rotation );
+				  G_NodeIndexAfter( instruction->node, rotation ), rotation );
+				G_PushRotationStack( rotation );
 
-				if ( G_GotoLabel( rotation, nodeIndex, node->u.label.name,
-				                  ( node->type == NT_GOTO ), depth ) )
+				rotation = instruction->target;
+				G_SetCurrentRotation( rotation );
+
+				if ( instruction->reset )
 				{
-					return false;
+					G_SetCurrentNodeByIndex( 0, rotation );
 				}
 
-				Log::Warn("label, map, or rotation %s not found in %s",
-				          node->u.label.name, G_RotationNameByIndex( rotation ) );
+				pc = G_CurrentInstruction( rotation );
 				break;
-		}
-	}
-
-	return true;
-}
-
-/*
-===============
-G_AdvanceMapRotation
 
-Increment the current map rotation
-===============
-*/
-void G_AdvanceMapRotation( int depth )
-{
-	mrNode_t *node;
-	int    rotation;
-	int    nodeIndex;
+			case MR_RETURN:
+				returnRotation = G_PopRotationStack();
 
-	rotation = g_currentMapRotation.integer;
+				if ( returnRotation < 0 || returnRotation >= mapRotations.numRotations )
+				{
+					pc++;
+					break;
+				}
 
-	if ( rotation < 0 || rotation >= MAX_MAP_ROTATIONS )
-	{
-		return;
-	}
+				G_SetCurrentNodeByIndex(
+				  G_NodeIndexAfter( instruction->node, rotation ), rotation );
 
-	nodeIndex = G_CurrentNodeIndex( rotation );
-	node = G_NodeByIndex( nodeIndex, rotation );
+				rotation = returnRotation;
+				G_SetCurrentRotation( rotation );
 
-	if ( !node )
-	{
-		Log::Warn("index incorrect for map rotation %s, trying 0",
-		          G_RotationNameByIndex( rotation ) );
-		nodeIndex = 0;
-		node = G_NodeByIndex( nodeIndex, rotation );
-	}
+				pc = G_CurrentInstruction( rotation );
 
-	while ( node && G_StepMapRotation( rotation, nodeIndex, depth ) )
-	{
-		nodeIndex = G_NodeIndexAfter( nodeIndex, rotation );
-		node = G_NodeByIndex( nodeIndex, rotation );
-		depth++;
+				// the stack only holds so many rotations
+				steps = mapRotationProgram.size() * ( mapRotations.numRotations + 1 );
+				break;
+		}
 	}
 
-	if ( !node )
-	{
-		Log::Warn("unexpected end of maprotation '%s'",
-		          G_RotationNameByIndex( rotation ) );
-	}
+	// the conditions kept it looping, stay on the current map
+	Log::Warn("infinite loop protection stopped at map rotation %s",
+	          G_RotationNameByIndex( rotation ) );
+	trap_SendConsoleCommand( "map_restart" );
 }
 
 /*
@@ -1361,45 +1745,34 @@ Switch to a new map rotation
 ===============
 */
 bool G_StartMapRotation( const char *name, bool advance,
-                             bool putOnStack, bool reset_index, int depth )
+                             bool putOnStack, bool reset_index )
 {
-	int i;
+	int rotation = G_RotationIndex( name );
 	int currentRotation = g_currentMapRotation.integer;
 
-	for ( i = 0; i < mapRotations.numRotations; i++ )
+	if ( rotation < 0 )
 	{
-		if ( !Q_stricmp( mapRotations.rotations[ i ].name, name ) )
-		{
-			if ( putOnStack && currentRotation >= 0 )
-			{
-				G_PushRotationStack( currentRotation );
-			}
-
-			trap_Cvar_Set( "g_currentMapRotation", va( "%d", i ) );
-			trap_Cvar_Update( &g_currentMapRotation );
-
-			if ( advance )
-			{
-				if ( reset_index )
-				{
-					G_SetCurrentNodeByIndex( 0, i );
-				}
-
-				G_AdvanceMapRotation( depth );
-			}
-
-			break;
-		}
+		return false;
 	}
 
-	if ( i == mapRotations.numRotations )
+	if ( putOnStack && currentRotation >= 0 )
 	{
-		return false;
+		G_PushRotationStack( currentRotation );
 	}
-	else
+
+	G_SetCurrentRotation( rotation );
+
+	if ( advance )
 	{
-		return true;
+		if ( reset_index )
+		{
+			G_SetCurrentNodeByIndex( 0, rotation );
+		}
+
+		G_AdvanceMapRotation();
 	}
+
+	return true;
 }
 
 /*
@@ -1411,8 +1784,7 @@ Stop the current map rotation
 */
 void G_StopMapRotation()
 {
-	trap_Cvar_Set( "g_currentMapRotation", va( "%d", NOT_ROTATING ) );
-	trap_Cvar_Update( &g_currentMapRotation );
+	G_SetCurrentRotation( NOT_ROTATING );
 }
 
 /*
@@ -1431,7 +1803,7 @@ bool G_MapRotationActive()
 ===============
 G_InitMapRotations
 
-Load and initialise the map rotations
+Load, compile and initialise the map rotations
 ===============
 */
 void G_InitMapRotations()
@@ -1445,17 +1817,27 @@ void G_InitMapRotations()
 		{
 			Log::Warn("failed to parse %s file", fileName );
 		}
+
+		// only the rotations that validate are kept
+		bool valid = G_ValidateMapRotations();
+
+		if ( !G_CompileMapRotations() || !valid )
+		{
+			Log::Warn("some map rotations of %s are not used", fileName );
+		}
 	}
 	else
 	{
 		Log::Warn( "%s file not found.", fileName );
 	}
 
+	G_LoadCurrentNodes();
+
 	if ( g_currentMapRotation.integer == NOT_ROTATING )
 	{
 		if ( g_initialMapRotation.string[ 0 ] != 0 )
 		{
-			G_StartMapRotation( g_initialMapRotation.string, false, true, false, 0 );
+			G_StartMapRotation( g_initialMapRotation.string, false, true, false );
 
 			trap_Cvar_Set( "g_initialMapRotation", "" );
 			trap_Cvar_Update( &g_initialMapRotation );
@@ -1472,7 +1854,8 @@ Free up memory used by a node
 */
 void G_FreeNode( mrNode_t *node )
 {
-	if ( node->type == NT_CONDITION )
+	// the target is missing if the condition failed to parse
+	if ( node->type == NT_CONDITION && node->u.condition.target )
 	{
 		G_FreeNode( node->u.condition.target );
 	}
@@ -1504,4 +1887,5 @@ void G_ShutdownMapRotations()
 	}
 
 	memset( &mapRotations, 0, sizeof( mapRotations ) );
+	mapRotationProgram.clear();
 }
@@ -558,9 +558,14 @@ void G_RunMissile( gentity_t *ent )
 		}
 	}
 
-	ent->r.contents = CONTENTS_SOLID; //trick trap_LinkEntity into...
-	trap_LinkEntity( ent );
-	ent->r.contents = 0; //...encoding bbox information
+	// missiles at rest, like grenades, don't need to recompute their leafs every frame
+	// s.solid is only set by the links below
+	if ( !ent->s.solid || !G_LinkedInPlace( ent ) )
+	{
+		ent->r.contents = CONTENTS_SOLID; //trick trap_LinkEntity into...
+		trap_LinkEntity( ent );
+		ent->r.contents = 0; //...encoding bbox information
+	}
 
 	if ( ent->flightSplashDamage )
 	{
@@ -241,6 +241,8 @@ static float AddMomentum( momentum_t type, team_t team, float amount,
 		// add momentum to team
 		level.team[ team ].momentum += amount;
 
+		G_EventLogMomentum( team, type, source, amount );
+
 		// run change hook if requested
 		if ( !skipChangeHook )
 		{
@@ -85,6 +85,115 @@ static void G_Bounce( gentity_t *ent, trace_t *trace )
 
 #define PHYSICS_TIME 200
 
+/*
+================
+G_PhysicsRest
+
+Stops the entity checking its floor, until G_PhysicsWake. Entities resting on
+another one are kept in a list of that ground, for G_PhysicsWakeResting.
+================
+*/
+static void G_PhysicsRest( gentity_t *ent, gentity_t *ground )
+{
+	ent->physicsResting = true;
+	ent->physicsGround = ground;
+
+	if ( ground )
+	{
+		ent->physicsRestingPrev = nullptr;
+		ent->physicsRestingNext = ground->physicsRestingHead;
+
+		if ( ground->physicsRestingHead )
+		{
+			ground->physicsRestingHead->physicsRestingPrev = ent;
+		}
+
+		ground->physicsRestingHead = ent;
+	}
+}
+
+/*
+================
+G_PhysicsWake
+
+Makes a resting entity check what it is sitting on again in its next frame.
+================
+*/
+void G_PhysicsWake( gentity_t *ent )
+{
+	if ( !ent->physicsResting )
+	{
+		return;
+	}
+
+	gentity_t *ground = ent->physicsGround;
+
+	if ( ground )
+	{
+		if ( ent->physicsRestingPrev )
+		{
+			ent->physicsRestingPrev->physicsRestingNext = ent->physicsRestingNext;
+		}
+		else
+		{
+			ground->physicsRestingHead = ent->physicsRestingNext;
+		}
+
+		if ( ent->physicsRestingNext )
+		{
+			ent->physicsRestingNext->physicsRestingPrev = ent->physicsRestingPrev;
+		}
+	}
+
+	ent->physicsResting = false;
+	ent->physicsGround = nullptr;
+	ent->physicsRestingNext = ent->physicsRestingPrev = nullptr;
+	ent->nextPhysicsTime = 0;
+}
+
+/*
+================
+G_PhysicsWakeResting
+
+Wakes the entities resting on ground, called when it moves or is freed.
+================
+*/
+void G_PhysicsWakeResting( gentity_t *ground )
+{
+	while ( ground->physicsRestingHead )
+	{
+		G_PhysicsWake( ground->physicsRestingHead );
+	}
+}
+
+/*
+================
+G_PhysicsCanRest
+
+Whether the floor found by the trace can only go away in a way that wakes the
+entity: the world, or an entity that wakes what rests on it when it moves.
+Players move without telling anyone, so the entities on them keep checking.
+================
+*/
+static bool G_PhysicsCanRest( gentity_t *ent, const trace_t *tr )
+{
+	if ( tr->startsolid || tr->entityNum != ent->s.groundEntityNum )
+	{
+		return false;
+	}
+
+	if ( tr->entityNum == ENTITYNUM_WORLD )
+	{
+		return true;
+	}
+
+	gentity_t *ground = &g_entities[ tr->entityNum ];
+
+	return tr->entityNum >= MAX_CLIENTS &&
+	       ( ground->s.eType == entityType_t::ET_MOVER || ground->s.eType == entityType_t::ET_BUILDABLE ||
+	         ground->s.eType == entityType_t::ET_CORPSE || ground->physicsObject );
+}
+
 /*
 ================
 G_Physics
@@ -120,8 +229,8 @@ void G_Physics( gentity_t *ent, int )
 		// check think function
 		G_RunThink( ent );
 
-		//check floor infrequently
-		if ( ent->nextPhysicsTime < level.time )
+		//check floor infrequently, and not at all while resting on something that wakes us
+		if ( !ent->physicsResting && ent->nextPhysicsTime < level.time )
 		{
 			VectorCopy( ent->r.currentOrigin, origin );
 
@@ -134,6 +243,10 @@ void G_Physics( gentity_t *ent, int )
 			{
 				ent->s.groundEntityNum = ENTITYNUM_NONE;
 			}
+			else if ( G_PhysicsCanRest( ent, &tr ) )
+			{
+				G_PhysicsRest( ent, tr.entityNum != ENTITYNUM_WORLD ? &g_entities[ tr.entityNum ] : nullptr );
+			}
 
 			ent->nextPhysicsTime = level.time + PHYSICS_TIME;
 		}
@@ -141,6 +254,8 @@ void G_Physics( gentity_t *ent, int )
 		return;
 	}
 
+	G_PhysicsWake( ent );
+
 	// trace a line from the previous position to the current position
 
 	// get current position
@@ -156,7 +271,11 @@ void G_Physics( gentity_t *ent, int )
 		tr.fraction = 0;
 	}
 
-	trap_LinkEntity( ent );  // FIXME: avoid this for stationary?
+	if ( !G_LinkedInPlace( ent ) )
+	{
+		trap_LinkEntity( ent );
+		G_PhysicsWakeResting( ent );
+	}
 
 	// check think function
 	G_RunThink( ent );
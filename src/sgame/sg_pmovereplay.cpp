@@ -0,0 +1,256 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2016 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished.  If not, see <http://www.gnu.org/licenses/>.
+
+===========================================================================
+*/
+
+// sg_pmovereplay.cpp -- recording and replay of player moves
+
+/*
+With g_pmoveRecord, the input and the output of every Pmove of the clients,
+spectators included, are written to pmove/<date>_<map>.pmove. The pmoveReplay
+command runs the recorded inputs through Pmove again on the running game, see
+BG_PmoveReplay. The standalone pmovereplay program does the same against the
+map alone.
+*/
+
+#include "sg_local.h"
+
+#define PMOVE_RECORD_BUFFER_SIZE 65536
+
+static Cvar::Cvar<bool> g_pmoveRecord( "g_pmoveRecord", "record the moves of the clients to pmove/ for pmoveReplay", Cvar::NONE, false );
+
+static struct
+{
+	fileHandle_t  file;
+	std::string   buffer;
+	pmoveRecord_t pending;
+	int           records;
+} pmoveRecording;
+
+static void G_PmoveRecordHeader( pmoveRecordHeader_t *header )
+{
+	char mapname[ MAX_QPATH ];
+
+	trap_Cvar_VariableStringBuffer( "mapname", mapname, sizeof( mapname ) );
+	BG_PmoveRecordHeader( header, mapname );
+}
+
+static void G_PmoveRecordFlush()
+{
+	if ( pmoveRecording.file && !pmoveRecording.buffer.empty() )
+	{
+		trap_FS_Write( pmoveRecording.buffer.data(), pmoveRecording.buffer.size(), pmoveRecording.file );
+	}
+
+	pmoveRecording.buffer.clear();
+}
+
+/*
+======================
+G_PmoveRecordStop
+======================
+*/
+void G_PmoveRecordStop()
+{
+	if ( !pmoveRecording.file )
+	{
+		return;
+	}
+
+	G_PmoveRecordFlush();
+	trap_FS_FCloseFile( pmoveRecording.file );
+	pmoveRecording.file = 0;
+
+	Log::Notice( "%i moves recorded", pmoveRecording.records );
+}
+
+/*
+======================
+G_PmoveRecordStart
+
+Returns whether moves are recorded.
+======================
+*/
+static bool G_PmoveRecordStart()
+{
+	char                filename[ MAX_QPATH ];
+	pmoveRecordHeader_t header;
+	qtime_t             qt;
+
+	if ( !g_pmoveRecord.Get() )
+	{
+		G_PmoveRecordStop();
+		return false;
+	}
+
+	if ( pmoveRecording.file )
+	{
+		return true;
+	}
+
+	G_PmoveRecordHeader( &header );
+	Com_GMTime( &qt );
+	Com_sprintf( filename, sizeof( filename ), "pmove/%04i%02i%02i_%02i%02i%02i_%s.pmove",
+	             1900 + qt.tm_year, qt.tm_mon + 1, qt.tm_mday,
+	             qt.tm_hour, qt.tm_min, qt.tm_sec, header.mapname );
+
+	trap_FS_FOpenFile( filename, &pmoveRecording.file, fsMode_t::FS_WRITE );
+
+	if ( !pmoveRecording.file )
+	{
+		Log::Warn( "Couldn't open %s, disabling g_pmoveRecord", filename );
+		g_pmoveRecord.Set( false );
+		return false;
+	}
+
+	Log::Notice( "Recording moves to %s", filename );
+
+	pmoveRecording.records = 0;
+	pmoveRecording.buffer.reserve( PMOVE_RECORD_BUFFER_SIZE + sizeof( pmoveRecord_t ) );
+	pmoveRecording.buffer.assign( ( const char * ) &header, sizeof( header ) );
+
+	return true;
+}
+
+/*
+======================
+G_PmoveRecordInput
+
+Called before Pmove.
+======================
+*/
+void G_PmoveRecordInput( const pmove_t *pm )
+{
+	if ( !G_PmoveRecordStart() )
+	{
+		return;
+	}
+
+	pmoveRecording.pending.clientNum = pm->ps->clientNum;
+	pmoveRecording.pending.tracemask = pm->tracemask;
+	pmoveRecording.pending.pmoveFixed = pm->pmove_fixed;
+	pmoveRecording.pending.pmoveMsec = pm->pmove_msec;
+	pmoveRecording.pending.pmoveAccurate = pm->pmove_accurate;
+	pmoveRecording.pending.cmd = pm->cmd;
+	pmoveRecording.pending.psIn = *pm->ps;
+	pmoveRecording.pending.pmextIn = *pm->pmext;
+}
+
+/*
+======================
+G_PmoveRecordOutput
+
+Called after Pmove.
+======================
+*/
+void G_PmoveRecordOutput( const pmove_t *pm )
+{
+	if ( !pmoveRecording.file )
+	{
+		return;
+	}
+
+	pmoveRecording.pending.psOut = *pm->ps;
+	pmoveRecording.pending.pmextOut = *pm->pmext;
+	pmoveRecording.buffer.append( ( const char * ) &pmoveRecording.pending, sizeof( pmoveRecord_t ) );
+	pmoveRecording.records++;
+
+	if ( pmoveRecording.buffer.size() >= PMOVE_RECORD_BUFFER_SIZE )
+	{
+		G_PmoveRecordFlush();
+	}
+}
+
+/*
+======================
+G_PmoveReplay_f
+
+pmoveReplay <file> [iterations]
+======================
+*/
+void G_PmoveReplay_f()
+{
+	char                filename[ MAX_QPATH ], iterations[ 16 ];
+	pmoveRecordHeader_t expected, *header;
+	const pmoveRecord_t *records;
+	pmoveReplayResult_t result;
+	std::vector<char>   data;
+	fileHandle_t        f;
+	int                 len, numRecords, numIterations;
+
+	if ( trap_Argc() < 2 )
+	{
+		Log::Notice( "usage: pmoveReplay <file> [iterations]" );
+		return;
+	}
+
+	trap_Argv( 1, filename, sizeof( filename ) );
+	trap_Argv( 2, iterations, sizeof( iterations ) );
+	numIterations = std::max( 1, atoi( iterations ) );
+
+	len = trap_FS_FOpenFile( filename, &f, fsMode_t::FS_READ );
+
+	if ( len < ( int ) sizeof( pmoveRecordHeader_t ) )
+	{
+		Log::Warn( "pmoveReplay: couldn't read %s", filename );
+
+		if ( f )
+		{
+			trap_FS_FCloseFile( f );
+		}
+
+		return;
+	}
+
+	data.resize( len );
+	trap_FS_Read( data.data(), len, f );
+	trap_FS_FCloseFile( f );
+
+	header = ( pmoveRecordHeader_t * ) data.data();
+	G_PmoveRecordHeader( &expected );
+
+	if ( !BG_PmoveRecordCompatible( header ) )
+	{
+		Log::Warn( "pmoveReplay: %s was not recorded by a compatible build", filename );
+		return;
+	}
+
+	if ( Q_stricmp( header->mapname, expected.mapname ) )
+	{
+		Log::Warn( "pmoveReplay: %s was recorded on %s", filename, header->mapname );
+	}
+
+	records = ( const pmoveRecord_t * )( data.data() + sizeof( pmoveRecordHeader_t ) );
+	numRecords = ( len - sizeof( pmoveRecordHeader_t ) ) / sizeof( pmoveRecord_t );
+
+	BG_PmoveReplay( records, numRecords, numIterations, trap_Trace, trap_PointContents, &result );
+
+	Log::Notice( "%i moves (%i PmoveSingle) replayed %i times, %.0f ns per PmoveSingle", result.moves, result.steps,
+	             numIterations, result.steps ? result.nanoseconds / ( ( double ) result.steps * numIterations ) : 0.0 );
+	Log::Notice( "%i of %i moves differ from the recording, hash %08x", result.mismatches, result.moves, result.hash );
+
+	if ( result.mismatches && g_debugMove.integer )
+	{
+		Log::Notice( "pmoveReplay: first mismatch at move %i of client %i", result.firstMismatch,
+		             records[ result.firstMismatch ].clientNum );
+	}
+}
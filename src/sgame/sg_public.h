@@ -34,6 +34,10 @@ void              G_UnlaggedOff();
 void              ClientThink( int clientNum );
 void              ClientEndFrame( gentity_t *ent );
 void              G_RunClient( gentity_t *ent );
+void              G_InitTriggerGrid();
+void              G_LinkTrigger( gentity_t *ent );
+void              G_UnlinkTrigger( gentity_t *ent );
+int               G_TriggersInBox( const vec3_t mins, const vec3_t maxs, int *list, int maxcount );
 void              G_TouchTriggers( gentity_t *ent );
 
 // sg_admin.c
@@ -120,6 +124,8 @@ gentity_t         *G_Build( gentity_t *builder, buildable_t buildable, const vec
 bool              G_BuildableInRange( vec3_t origin, float radius, buildable_t buildable );
 void              G_Deconstruct( gentity_t *self, gentity_t *deconner, meansOfDeath_t deconType );
 itemBuildError_t  G_CanBuild( gentity_t *ent, buildable_t buildable, int distance, vec3_t origin, vec3_t normal, int *groundEntNum );
+int               G_BuildableSetSignature();
+void              G_InvalidateBuildablePowerStates();
 bool              G_BuildIfValid( gentity_t *ent, buildable_t buildable );
 void              G_SetBuildableAnim(gentity_t *ent, buildableAnimNumber_t animation, bool force);
 void              G_SetIdleBuildableAnim(gentity_t *ent, buildableAnimNumber_t animation);
@@ -271,11 +277,20 @@ void              G_CheckPmoveParamChanges();
 void              G_SendClientPmoveParams(int client);
 void              G_PrepareEntityNetCode();
 
+// sg_eventlog.cpp
+void              G_EventLogInit();
+void              G_EventLogFrame();
+void              G_EventLogShutdown();
+void              G_EventLogKill( gentity_t *self, int killer, int assistant, team_t assistantTeam, meansOfDeath_t mod );
+void              G_EventLogDamage( gentity_t *target, gentity_t *source, float amount, meansOfDeath_t mod );
+void              G_EventLogBuild( const buildLog_t *log );
+void              G_EventLogMomentum( team_t team, int reason, gentity_t *source, float amount );
+
 // sg_maprotation.c
 void              G_PrintRotations();
 void              G_PrintCurrentRotation( gentity_t *ent );
-void              G_AdvanceMapRotation( int depth );
-bool          G_StartMapRotation( const char *name, bool advance, bool putOnStack, bool reset_index, int depth );
+void              G_AdvanceMapRotation();
+bool          G_StartMapRotation( const char *name, bool advance, bool putOnStack, bool reset_index );
 void              G_StopMapRotation();
 bool          G_MapRotationActive();
 void              G_InitMapRotations();
@@ -297,6 +312,14 @@ void              G_namelog_cleanup();
 
 // sg_physcis.c
 void              G_Physics( gentity_t *ent, int msec );
+void              G_PhysicsWake( gentity_t *ent );
+void              G_PhysicsWakeResting( gentity_t *ground );
+
+// sg_pmovereplay.cpp
+void              G_PmoveRecordInput( const pmove_t *pm );
+void              G_PmoveRecordOutput( const pmove_t *pm );
+void              G_PmoveRecordStop();
+void              G_PmoveReplay_f();
 
 // sg_session.c
 void              G_ReadSessionData( gclient_t *client );
@@ -321,6 +344,10 @@ void              TeamplayInfoMessage( gentity_t *ent );
 void              CheckTeamStatus();
 void              G_UpdateTeamConfigStrings();
 
+// sg_threats.cpp
+void              G_ForThreatsInRange( const vec3_t origin, float range, team_t ownTeam,
+                                       const std::function<void(Entity&)> &func );
+
 // sg_utils.c
 bool          G_AddressParse( const char *str, addr_t *addr );
 bool          G_AddressCompare( const addr_t *a, const addr_t *b );
@@ -350,6 +377,7 @@ void              G_ClientnumToMask( int clientNum, int *loMask, int *hiMask );
 void              G_TeamToClientmask( team_t team, int *loMask, int *hiMask );
 void              G_FireThink( gentity_t *self );
 gentity_t         *G_SpawnFire(vec3_t origin, vec3_t normal, gentity_t *fireStarter );
+bool              G_LinkedInPlace( const gentity_t *ent );
 bool          G_LineOfSight( const gentity_t *from, const gentity_t *to, int mask, bool useTrajBase );
 bool          G_LineOfSight( const gentity_t *from, const gentity_t *to );
 bool          G_LineOfFire( const gentity_t *from, const gentity_t *to );
@@ -386,5 +414,6 @@ void              G_FireUpgrade( gentity_t *self, upgrade_t upgrade );
 
 // Components
 void G_IgnitableThink();
+void G_FireBenchmark_f();
 
 #endif // SG_PUBLIC_H_
@@ -616,22 +616,143 @@ bool G_CallSpawnFunction( gentity_t *spawnedEntity )
 	return false;
 }
 
+/*
+=============
+Entity strings
+
+The strings of entities are interned in an arena for the duration of the
+level: equal strings share the same pointer, so they can be compared with ==,
+and they are all released together by G_FreeEntityStrings.
+They must not be modified.
+=============
+*/
+
+#define STRING_ARENA_BLOCK_SIZE 65536
+
+struct stringHash
+{
+	size_t operator()( const char *string ) const
+	{
+		size_t hash = 2166136261u;
+
+		for ( ; *string; string++ )
+		{
+			hash = ( hash ^ ( byte ) *string ) * 16777619u;
+		}
+
+		return hash;
+	}
+};
+
+struct stringEqual
+{
+	bool operator()( const char *a, const char *b ) const
+	{
+		return !strcmp( a, b );
+	}
+};
+
+static struct
+{
+	std::vector<char*> blocks;
+	char               *cursor;
+	size_t             available;
+
+	std::unordered_set<const char*, stringHash, stringEqual> strings;
+
+	// statistics
+	int                requests;
+	size_t             requestedBytes;
+	size_t             allocatedBytes;
+} stringArena;
+
+static char *G_StringArenaAlloc( size_t size )
+{
+	char *string;
+
+	if ( size > stringArena.available )
+	{
+		size_t blockSize = std::max<size_t>( size, STRING_ARENA_BLOCK_SIZE );
+
+		stringArena.cursor = (char*) BG_Alloc( blockSize );
+		stringArena.available = blockSize;
+		stringArena.allocatedBytes += blockSize;
+		stringArena.blocks.push_back( stringArena.cursor );
+	}
+
+	string = stringArena.cursor;
+	stringArena.cursor += size;
+	stringArena.available -= size;
+
+	return string;
+}
+
+/*
+=============
+G_InternString
+
+Returns the level's copy of the string
+=============
+*/
+char *G_InternString( const char *string )
+{
+	size_t size = strlen( string ) + 1;
+	char   *copy;
+
+	stringArena.requests++;
+	stringArena.requestedBytes += size;
+
+	auto it = stringArena.strings.find( string );
+
+	if ( it != stringArena.strings.end() )
+	{
+		return const_cast<char*>( *it );
+	}
+
+	copy = G_StringArenaAlloc( size );
+	memcpy( copy, string, size );
+	stringArena.strings.insert( copy );
+
+	return copy;
+}
+
+/*
+=============
+G_FreeEntityStrings
+
+Releases all strings of the level
+=============
+*/
+void G_FreeEntityStrings()
+{
+	for ( char *block : stringArena.blocks )
+	{
+		BG_Free( block );
+	}
+
+	stringArena.blocks.clear();
+	stringArena.strings.clear();
+	stringArena.cursor = nullptr;
+	stringArena.available = 0;
+	stringArena.requests = 0;
+	stringArena.requestedBytes = 0;
+	stringArena.allocatedBytes = 0;
+}
+
 /*
 =============
 G_NewString
 
-Builds a copy of the string, translating \n to real linefeeds
+Interns the string, translating \n to real linefeeds
 so message texts can be multi-line
 =============
 */
 char *G_NewString( const char *string )
 {
-	char *newb, *new_p;
-	size_t l = strlen( string ) + 1;
-
-	newb = (char*) BG_Alloc( l );
+	std::string newString;
+	size_t l = strlen( string );
 
-	new_p = newb;
+	newString.reserve( l );
 
 	// turn \n into a real linefeed
 	for ( size_t i = 0; i < l; i++ )
@@ -642,20 +763,20 @@ char *G_NewString( const char *string )
 
 			if ( string[ i ] == 'n' )
 			{
-				*new_p++ = '\n';
+				newString += '\n';
 			}
 			else
 			{
-				*new_p++ = '\\';
+				newString += '\\';
 			}
 		}
 		else
 		{
-			*new_p++ = string[ i ];
+			newString += string[ i ];
 		}
 	}
 
-	return newb;
+	return G_InternString( newString.c_str() );
 }
 
 /*
@@ -665,26 +786,25 @@ G_NewTarget
 */
 gentityCallDefinition_t G_NewCallDefinition( const char *eventKey, const char *string )
 {
-	char *stringPointer;
+	const char *separator;
 	gentityCallDefinition_t newCallDefinition = { nullptr, ON_DEFAULT, nullptr, nullptr, ECA_NOP };
 
-	size_t stringLength = strlen( string ) + 1;
-	if ( stringLength == 1 )
+	if ( !*string )
 		return newCallDefinition;
 
-	stringPointer = (char*) BG_Alloc( stringLength );
-	newCallDefinition.name = stringPointer;
+	// name:action
+	separator = strchr( string, ':' );
 
-	for ( size_t i = 0; i < stringLength; i++ )
+	if ( separator )
 	{
-		if ( string[ i ] == ':' && !newCallDefinition.action )
-		{
-			*stringPointer++ = '\0';
-			newCallDefinition.action = stringPointer;
-			continue;
-		}
-		*stringPointer++ = string[ i ];
+		newCallDefinition.name = G_InternString( std::string( string, separator ).c_str() );
+		newCallDefinition.action = G_InternString( separator + 1 );
 	}
+	else
+	{
+		newCallDefinition.name = G_InternString( string );
+	}
+
 	newCallDefinition.actionType = G_GetCallActionTypeFor( newCallDefinition.action );
 
 	newCallDefinition.event = eventKey;
@@ -871,6 +991,9 @@ void G_SpawnGEntityFromSpawnVars()
 	}
 	spawningEntity->targets[ j ] = nullptr;
 
+	G_IndexEntityNames( spawningEntity );
+	G_ResolveEntityTargets( spawningEntity );
+
 	// if we didn't get necessary fields (like the classname), don't bother spawning anything
 	if ( !G_CallSpawnFunction( spawningEntity ) )
 	{
@@ -1105,6 +1228,8 @@ Parses textual entity definitions out of an entstring and spawns gentities.
 */
 void G_SpawnEntitiesFromString()
 {
+	int startTime = trap_Milliseconds();
+
 	level.numSpawnVars = 0;
 
 	// the worldspawn is not an actual entity, but it still
@@ -1122,6 +1247,14 @@ void G_SpawnEntitiesFromString()
 	{
 		G_SpawnGEntityFromSpawnVars();
 	}
+
+	if ( g_debugEntities.integer > 0 )
+	{
+		Log::Notice( "%i entities spawned in %i ms, %i strings (%i unique) in %i KB instead of %i KB",
+		             level.num_entities - MAX_CLIENTS, trap_Milliseconds() - startTime,
+		             stringArena.requests, (int) stringArena.strings.size(),
+		             (int) ( stringArena.allocatedBytes / 1024 ), (int) ( stringArena.requestedBytes / 1024 ) );
+	}
 }
 
 void G_SpawnFakeEntities()
@@ -34,6 +34,7 @@ Maryland 20850 USA.
 
 #include "sg_local.h"
 #include "sg_spawn.h"
+#include "sg_cm_world.h"
 #include "CBSE.h"
 
 #define DEFAULT_FUNC_TRAIN_SPEED 100
@@ -56,6 +57,22 @@ typedef struct
 
 pushed_t pushed[ MAX_GENTITIES ], *pushed_p;
 
+/*
+============
+G_Pushable
+
+G_CM_LinkEntity keeps the entities for which this is true in a separate chain
+of their sector, which G_CM_AreaPushables walks.
+============
+*/
+bool G_Pushable( const gentity_t *ent )
+{
+	// only push items and players
+	return ent->s.eType == entityType_t::ET_ITEM || ent->s.eType == entityType_t::ET_BUILDABLE ||
+	       ent->s.eType == entityType_t::ET_CORPSE || ent->s.eType == entityType_t::ET_PLAYER ||
+	       ent->physicsObject;
+}
+
 /*
 ============
 G_TestEntityPosition
@@ -225,6 +242,7 @@ bool G_TryPushingEntity( gentity_t *check, gentity_t *pusher, vec3_t move, vec3_
 		}
 
 		trap_LinkEntity( check );
+		G_PhysicsWake( check );
 		return true;
 	}
 
@@ -252,6 +270,19 @@ bool G_TryPushingEntity( gentity_t *check, gentity_t *pusher, vec3_t move, vec3_
 	return false;
 }
 
+/*
+============
+G_MoverStationary
+
+Whether the mover is at rest in both position and angles
+============
+*/
+static bool G_MoverStationary( const gentity_t *mover )
+{
+	return ( mover->s.pos.trType == trType_t::TR_STATIONARY || VectorCompare( mover->s.pos.trDelta, vec3_origin ) ) &&
+	       ( mover->s.apos.trType == trType_t::TR_STATIONARY || VectorCompare( mover->s.apos.trDelta, vec3_origin ) );
+}
+
 /*
 ============
 G_MoverPush
@@ -273,6 +304,14 @@ bool G_MoverPush( gentity_t *pusher, vec3_t move, vec3_t amove, gentity_t **obst
 
 	*obstacle = nullptr;
 
+	// a mover at rest was already checked against what is in its bounds, nothing new can be
+	// in the way. A moving one whose move rounds to zero still has to push and be blocked.
+	if ( VectorCompare( move, vec3_origin ) && VectorCompare( amove, vec3_origin ) && pusher->r.linked &&
+	     G_MoverStationary( pusher ) )
+	{
+		return true;
+	}
+
 	// mins/maxs are the bounds at the destination
 	// totalMins / totalMaxs are the bounds for the entire move
 	if ( pusher->r.currentAngles[ 0 ] || pusher->r.currentAngles[ 1 ] || pusher->r.currentAngles[ 2 ]
@@ -314,25 +353,22 @@ bool G_MoverPush( gentity_t *pusher, vec3_t move, vec3_t amove, gentity_t **obst
 		}
 	}
 
-	// unlink the pusher so we don't get it in the entityList
-	trap_UnlinkEntity( pusher );
-
-	listedEntities = trap_EntitiesInBox( totalMins, totalMaxs, entityList, MAX_GENTITIES );
+	// only the pushable entities are listed, in the order of the whole sector query
+	listedEntities = G_CM_AreaPushables( totalMins, totalMaxs, entityList, MAX_GENTITIES );
 
 	// move the pusher to its final position
 	VectorAdd( pusher->r.currentOrigin, move, pusher->r.currentOrigin );
 	VectorAdd( pusher->r.currentAngles, amove, pusher->r.currentAngles );
 	trap_LinkEntity( pusher );
+	G_PhysicsWakeResting( pusher );
 
 	// see if any solid entities are inside the final position
 	for ( e = 0; e < listedEntities; e++ )
 	{
 		check = &g_entities[ entityList[ e ] ];
 
-		// only push items and players
-		if ( check->s.eType != entityType_t::ET_ITEM && check->s.eType != entityType_t::ET_BUILDABLE &&
-		     check->s.eType != entityType_t::ET_CORPSE && check->s.eType != entityType_t::ET_PLAYER &&
-		     !check->physicsObject )
+		// the pusher itself, or an entity that changed type since it was linked
+		if ( check == pusher || !G_Pushable( check ) )
 		{
 			continue;
 		}
@@ -1272,12 +1308,12 @@ void InitMover( gentity_t *ent )
 
 	if ( G_SpawnString( "group", "", &groupName ) )
 	{
-		ent->groupName = G_CopyString( groupName );
+		ent->groupName = G_InternString( groupName );
 	}
 	else if ( G_SpawnString( "team", "", &groupName ) )
 	{
 		G_WarnAboutDeprecatedEntityField( ent, "group", "team", ENT_V_RENAMED );
-		ent->groupName = G_CopyString( groupName );
+		ent->groupName = G_InternString( groupName );
 	}
 
 	ent->moverState = MOVER_POS1;
@@ -1339,12 +1375,12 @@ void InitRotator( gentity_t *ent )
 
 	if ( G_SpawnString( "group", "", &groupName ) )
 	{
-		ent->groupName = G_CopyString( groupName );
+		ent->groupName = G_InternString( groupName );
 	}
 	else if ( G_SpawnString( "team", "", &groupName ) )
 	{
 		G_WarnAboutDeprecatedEntityField( ent, "group", "team", ENT_V_RENAMED );
-		ent->groupName = G_CopyString( groupName );
+		ent->groupName = G_InternString( groupName );
 	}
 
 	ent->moverState = ROTATOR_POS1;
@@ -182,6 +182,7 @@ struct gentity_s
 	 */
 	int          targetCount;
 	char         *targets[ MAX_ENTITY_TARGETS + 1 ];
+	entityNameList_t *targetLists[ MAX_ENTITY_TARGETS ]; // resolved targets, set on first use
 	gentity_t    *target;  /*< the currently selected target to aim at/for, is the reverse to "tracker" */
 	gentity_t    *tracker; /*< entity that currently targets, aims for or tracks this entity, is the reverse to "target" */
 	int          numTrackedBy;
@@ -340,6 +341,10 @@ struct gentity_s
 	int         overmindSpawnsTimer;
 	int         nextPhysicsTime; // buildables don't need to check what they're sitting on
 	// every single frame.. so only do it periodically
+	bool        physicsResting; // stopped checking its floor until woken by G_PhysicsWake
+	gentity_t   *physicsGround; // the entity it is resting on, nullptr for the world
+	gentity_t   *physicsRestingHead; // the entities resting on it, see G_PhysicsWakeResting
+	gentity_t   *physicsRestingNext, *physicsRestingPrev; // in the list of physicsGround
 	int         clientSpawnTime; // the time until this spawn can spawn a client
 
 	struct {
@@ -620,6 +625,18 @@ struct buildLog_s
 	vec3_t      angles2;
 };
 
+/**
+ * what CalculateRanks counted a client as
+ */
+struct censusEntry_s
+{
+	bool   listed;  // not disconnected, in sortedClients
+	team_t team;
+	bool   bot;
+	bool   playing; // connected and on a team
+	bool   alive;   // playing and not spectating
+};
+
 #define MAX_SPAWN_VARS       64
 #define MAX_SPAWN_VARS_CHARS 4096
 #define MAX_BUILDLOG         1024
@@ -664,6 +681,10 @@ struct level_locals_s
 
 	int      sortedClients[ MAX_CLIENTS ]; // sorted by score
 
+	censusEntry_t census[ MAX_CLIENTS ]; // the counts above are kept up to date from these
+	char          censusP[ MAX_CLIENTS + 1 ]; // last values of the P and B cvars
+	char          censusB[ MAX_CLIENTS + 1 ];
+
 	int      snd_fry; // sound index for standing in lava
 
 	int      warmupModificationCount; // for detecting if g_warmup is changed
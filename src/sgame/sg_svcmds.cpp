@@ -462,7 +462,7 @@ static void Svcmd_MapRotation_f()
 
 	trap_Argv( 1, rotationName, sizeof( rotationName ) );
 
-	if ( !G_StartMapRotation( rotationName, false, true, false, 0 ) )
+	if ( !G_StartMapRotation( rotationName, false, true, false ) )
 	{
 		Log::Notice( "maprotation: invalid map rotation \"%s\"", rotationName );
 	}
@@ -677,7 +677,7 @@ static void Svcmd_MapLogWrapper()
 
 static void Svcmd_G_AdvanceMapRotation_f()
 {
-	G_AdvanceMapRotation( 0 );
+	G_AdvanceMapRotation();
 }
 
 static const struct svcmd
@@ -700,6 +700,7 @@ static const struct svcmd
 	{ "entityList",         false, Svcmd_EntityList_f           },
 	{ "entityShow",         false, Svcmd_EntityShow_f           },
 	{ "evacuation",         false, Svcmd_Evacuation_f           },
+	{ "fireBenchmark",      false, G_FireBenchmark_f            },
 	{ "forceTeam",          false, Svcmd_ForceTeam_f            },
 	{ "humanWin",           false, Svcmd_TeamWin_f              },
 	{ "layoutLoad",         false, Svcmd_LayoutLoad_f           },
@@ -707,6 +708,7 @@ static const struct svcmd
 	{ "m",                  true,  Svcmd_MessageWrapper         },
 	{ "maplog",             true,  Svcmd_MapLogWrapper          },
 	{ "mapRotation",        false, Svcmd_MapRotation_f          },
+	{ "pmoveReplay",        false, G_PmoveReplay_f              },
 	{ "pr",                 false, Svcmd_Pr_f                   },
 	{ "printqueue",         false, Svcmd_PrintQueue_f           },
 	{ "say",                true,  Svcmd_MessageWrapper         },
@@ -0,0 +1,187 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2016 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished.  If not, see <http://www.gnu.org/licenses/>.
+
+===========================================================================
+*/
+
+// sg_threats.cpp -- per frame table of the players buildables can target
+
+/*
+The threat table lists the spawned players of every team, sorted into a grid
+of THREAT_CELL_SIZE cells on the horizontal plane. It is built on the first
+query of a frame, so the buildables looking for targets only visit the players
+in the cells within their range instead of all of them.
+
+Players usually only move in ClientEndFrame, after the buildables thought, but
+they can also be placed in the middle of a frame (spawns, teleports). The
+queries look THREAT_SLACK further to still find them, and they always test the
+current origin, so the callers see the same candidates as with ForEntities.
+*/
+
+#include "CBSE.h"
+
+#define THREAT_CELL_SIZE 256.0f
+#define THREAT_SLACK     128.0f
+
+// Beyond this many cells, walking the whole team is cheaper.
+#define THREAT_MAX_CELLS 64
+
+static struct
+{
+	int                                                   time = -1;
+	std::vector<gentity_t*>                               all[ NUM_TEAMS ];
+	std::unordered_map<uint32_t, std::vector<gentity_t*>> cells[ NUM_TEAMS ];
+} threatTable;
+
+static void G_AddThreat( gentity_t *ent, team_t team )
+{
+	uint32_t key = BG_GridCellKey( BG_GridCell( ent->s.origin[ 0 ], 0.0f, THREAT_CELL_SIZE ),
+	                               BG_GridCell( ent->s.origin[ 1 ], 0.0f, THREAT_CELL_SIZE ) );
+
+	threatTable.all[ team ].push_back( ent );
+	threatTable.cells[ team ][ key ].push_back( ent );
+}
+
+/*
+===============
+G_UpdateThreatTable
+
+Lists the players of every team once per frame.
+===============
+*/
+static void G_UpdateThreatTable()
+{
+	if ( threatTable.time == level.time )
+	{
+		return;
+	}
+
+	threatTable.time = level.time;
+
+	for ( int team = 0; team < NUM_TEAMS; team++ )
+	{
+		threatTable.all[ team ].clear();
+
+		// keep the cell vectors around, most of them are reused next frame
+		for ( auto &cell : threatTable.cells[ team ] )
+		{
+			cell.second.clear();
+		}
+	}
+
+	ForEntities<AlienClassComponent>([&](Entity& entity, AlienClassComponent&) {
+		G_AddThreat( entity.oldEnt, TEAM_ALIENS );
+	});
+
+	ForEntities<HumanClassComponent>([&](Entity& entity, HumanClassComponent&) {
+		G_AddThreat( entity.oldEnt, TEAM_HUMANS );
+	});
+}
+
+/*
+===============
+G_ForThreatsInRange
+
+Calls func for the players that are not on ownTeam and could be within range
+of origin, in entity number order. The callers still have to check the
+distance, range only limits the cells that are visited.
+===============
+*/
+void G_ForThreatsInRange( const vec3_t origin, float range, team_t ownTeam,
+                          const std::function<void(Entity&)> &func )
+{
+	gentity_t *list[ MAX_CLIENTS ];
+	int       count = 0;
+	float     reach = range + THREAT_SLACK;
+
+	G_UpdateThreatTable();
+
+	for ( int team = TEAM_NONE + 1; team < NUM_TEAMS; team++ )
+	{
+		if ( team == ownTeam || threatTable.all[ team ].empty() )
+		{
+			continue;
+		}
+
+		bool walkAll = reach >= THREAT_CELL_SIZE * THREAT_MAX_CELLS;
+
+		if ( !walkAll )
+		{
+			vec3_t mins = { origin[ 0 ] - reach, origin[ 1 ] - reach, origin[ 2 ] };
+			vec3_t maxs = { origin[ 0 ] + reach, origin[ 1 ] + reach, origin[ 2 ] };
+			int    cells[ 4 ];
+
+			BG_GridCells( vec3_origin, THREAT_CELL_SIZE, mins, maxs, cells );
+
+			walkAll = ( cells[ 2 ] - cells[ 0 ] + 1 ) * ( cells[ 3 ] - cells[ 1 ] + 1 ) > THREAT_MAX_CELLS;
+
+			for ( int x = cells[ 0 ]; !walkAll && x <= cells[ 2 ]; x++ )
+			{
+				for ( int y = cells[ 1 ]; y <= cells[ 3 ]; y++ )
+				{
+					auto cell = threatTable.cells[ team ].find( BG_GridCellKey( x, y ) );
+
+					if ( cell == threatTable.cells[ team ].end() )
+					{
+						continue;
+					}
+
+					for ( gentity_t *ent : cell->second )
+					{
+						list[ count++ ] = ent;
+					}
+				}
+			}
+		}
+
+		if ( walkAll )
+		{
+			for ( gentity_t *ent : threatTable.all[ team ] )
+			{
+				list[ count++ ] = ent;
+			}
+		}
+	}
+
+	std::sort( list, list + count, []( const gentity_t *a, const gentity_t *b ) {
+		return a->s.number < b->s.number;
+	} );
+
+	for ( int i = 0; i < count; i++ )
+	{
+		gentity_t *ent = list[ i ];
+
+		// the player may have left, died into a spectator or changed team since the table was built
+		if ( !ent->inuse || !ent->entity || ent->entity->Get<SpectatorComponent>() ||
+		     G_Team( ent ) == TEAM_NONE || G_Team( ent ) == ownTeam )
+		{
+			continue;
+		}
+
+		if ( fabsf( ent->s.origin[ 0 ] - origin[ 0 ] ) > range ||
+		     fabsf( ent->s.origin[ 1 ] - origin[ 1 ] ) > range )
+		{
+			continue;
+		}
+
+		func( *ent->entity );
+	}
+}
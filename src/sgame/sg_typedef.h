@@ -48,6 +48,7 @@ typedef struct gclient_s           gclient_t;
 typedef struct damageRegion_s      damageRegion_t;
 typedef struct spawnQueue_s        spawnQueue_t;
 typedef struct buildLog_s          buildLog_t;
+typedef struct censusEntry_s       censusEntry_t;
 typedef struct level_locals_s      level_locals_t;
 typedef struct commands_s          commands_t;
 typedef struct zap_s               zap_t;
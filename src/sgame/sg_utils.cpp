@@ -881,6 +881,38 @@ gentity_t *G_SpawnFire( vec3_t origin, vec3_t normal, gentity_t *fireStarter )
 	return fire;
 }
 
+/*
+================
+G_LinkedInPlace
+
+Whether linking the entity again would not change anything, because it is
+still linked at its current position with its current bounds.
+================
+*/
+bool G_LinkedInPlace( const gentity_t *ent )
+{
+	vec3_t absmin, absmax;
+
+	if ( !ent->r.linked || ent->r.bmodel )
+	{
+		return false;
+	}
+
+	// the same bounds as G_CM_LinkEntity
+	VectorAdd( ent->r.currentOrigin, ent->r.mins, absmin );
+	VectorAdd( ent->r.currentOrigin, ent->r.maxs, absmax );
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		if ( ent->r.absmin[ i ] != absmin[ i ] - 1 || ent->r.absmax[ i ] != absmax[ i ] + 1 )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool G_LineOfSight( const gentity_t *from, const gentity_t *to, int mask, bool useTrajBase )
 {
 	trace_t trace;
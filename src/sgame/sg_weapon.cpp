@@ -1273,16 +1273,31 @@ LEVEL2
 
 static zap_t zaps[ MAX_ZAPS ];
 
-static void FindZapChainTargets( zap_t *zap )
+struct zapCandidate_t
 {
-	gentity_t *ent = zap->targets[ 0 ]; // the source
-	int       entityList[ MAX_GENTITIES ];
-	vec3_t    range;
-	vec3_t    mins, maxs;
-	int       i, num;
-	gentity_t *enemy;
-	trace_t   tr;
+	gentity_t *ent;
 	float     distance;
+};
+
+/*
+===============
+FindZapChainTargets
+
+Chains to the closest humans and human buildables in range that the world
+doesn't hide, so only the candidates up to the target limit are traced to.
+===============
+*/
+static void FindZapChainTargets( zap_t *zap )
+{
+	gentity_t      *ent = zap->targets[ 0 ]; // the source
+	int            entityList[ MAX_GENTITIES ];
+	zapCandidate_t candidates[ MAX_GENTITIES ];
+	vec3_t         range;
+	vec3_t         mins, maxs;
+	int            i, num, numCandidates = 0;
+	gentity_t      *enemy;
+	trace_t        tr;
+	float          distance;
 
 	VectorSet(range, LEVEL2_AREAZAP_CHAIN_RANGE, LEVEL2_AREAZAP_CHAIN_RANGE, LEVEL2_AREAZAP_CHAIN_RANGE);
 
@@ -1310,19 +1325,33 @@ static void FindZapChainTargets( zap_t *zap )
 		     G_Alive( enemy ) &&
 		     distance <= LEVEL2_AREAZAP_CHAIN_RANGE )
 		{
-			// world-LOS check: trace against the world, ignoring other BODY entities
-			trap_Trace( &tr, ent->s.origin, nullptr, nullptr,
-			            enemy->s.origin, ent->s.number, CONTENTS_SOLID, 0 );
+			candidates[ numCandidates ].ent = enemy;
+			candidates[ numCandidates ].distance = distance;
+			numCandidates++;
+		}
+	}
 
-			if ( tr.entityNum == ENTITYNUM_NONE )
-			{
-				zap->targets[ zap->numTargets ] = enemy;
-				zap->distances[ zap->numTargets ] = distance;
+	// nearest first, ties in entity order
+	std::sort( candidates, candidates + numCandidates, []( const zapCandidate_t &a, const zapCandidate_t &b ) {
+		return a.distance < b.distance || ( a.distance == b.distance && a.ent->s.number < b.ent->s.number );
+	} );
 
-				if ( ++zap->numTargets >= LEVEL2_AREAZAP_MAX_TARGETS )
-				{
-					return;
-				}
+	for ( i = 0; i < numCandidates; i++ )
+	{
+		enemy = candidates[ i ].ent;
+
+		// world-LOS check: trace against the world, ignoring other BODY entities
+		trap_Trace( &tr, ent->s.origin, nullptr, nullptr,
+		            enemy->s.origin, ent->s.number, CONTENTS_SOLID, 0 );
+
+		if ( tr.entityNum == ENTITYNUM_NONE )
+		{
+			zap->targets[ zap->numTargets ] = enemy;
+			zap->distances[ zap->numTargets ] = candidates[ i ].distance;
+
+			if ( ++zap->numTargets >= LEVEL2_AREAZAP_MAX_TARGETS )
+			{
+				return;
 			}
 		}
 	}
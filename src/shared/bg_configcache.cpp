@@ -0,0 +1,744 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2016 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+===========================================================================
+*/
+
+// bg_configcache.cpp -- binary cache of the parsed gameplay configuration
+
+/*
+The result of parsing the gameplay configuration files is stored in a binary
+file, together with the name, length and hash of every file that was read to
+produce it. On the next start, the cache is used if all these files are still
+the same, and the parsers are skipped for every record found in it.
+
+Layout:
+  header:  magic, version, game version, layout hash, number of sources, number of records
+  sources: name, length (-1 if missing), whether it was read, hash
+  records: name, size, raw bytes, then the strings owned by the record
+*/
+
+#include "engine/qcommon/q_shared.h"
+#include "bg_public.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+int  trap_FS_FOpenFile( const char *qpath, fileHandle_t *f, fsMode_t mode );
+int  trap_FS_Read( void *buffer, int len, fileHandle_t f );
+int  trap_FS_Write( const void *buffer, int len, fileHandle_t f );
+void trap_FS_FCloseFile( fileHandle_t f );
+
+#define CONFIG_CACHE_MAGIC   0x43435655 // "UVCC"
+#define CONFIG_CACHE_VERSION 3 // bump when a parser changes what it makes of the same text
+
+// string tag for a null pointer, next to the configCacheStringType_t values
+#define CONFIG_CACHE_NULL    -1
+
+#if defined( BUILD_CGAME )
+#define CONFIG_CACHE_FILE "cache/cgame.configs"
+#elif defined( BUILD_SGAME )
+#define CONFIG_CACHE_FILE "cache/sgame.configs"
+#else
+#define CONFIG_CACHE_FILE "cache/pmovereplay.configs"
+#endif
+
+enum class configCacheMode_t
+{
+	IDLE,
+	READING,
+	WRITING
+};
+
+static struct
+{
+	configCacheMode_t mode;
+
+	// set when a source could not be recorded properly, the cache is then not written
+	bool broken;
+
+	std::string sources;
+	int numSources;
+	std::unordered_set<std::string> sourceNames;
+
+	std::string records;
+	int numRecords;
+	std::unordered_map<std::string, size_t> recordOffsets;
+} cache;
+
+static uint64_t ConfigCacheHash( const char *data, int length )
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	for ( int i = 0; i < length; i++ )
+	{
+		hash = ( hash ^ ( unsigned char ) data[ i ] ) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+// A cache written by another version of the game is not used, as the
+// defaults the parsers set and the way they read the files may have changed.
+// Changes to the cached structures are caught by ConfigCacheLayout.
+static std::string ConfigCacheBuild()
+{
+	return GAME_VERSION;
+}
+
+typedef struct
+{
+	const char *name;
+	size_t     offset;
+	size_t     size;
+} configCacheField_t;
+
+#define CONFIG_CACHE_STRUCT( type )       { #type, 0, sizeof( type ) }
+#define CONFIG_CACHE_FIELD( type, field ) { #type "." #field, offsetof( type, field ), sizeof( type::field ) }
+
+// every field of the records stored as raw bytes
+static const configCacheField_t configCacheFields[] =
+{
+	CONFIG_CACHE_STRUCT( buildableAttributes_t ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, number ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, name ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, humanName ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, info ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, entityName ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, icon ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, traj ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, bounce ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, buildPoints ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, unlockThreshold ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, health ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, regenRate ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, splashDamage ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, splashRadius ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, weapon ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, meansOfDeath ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, team ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, buildWeapon ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, buildTime ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, usable ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, minNormal ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, invertNormal ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, creepTest ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, creepSize ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, transparentTest ),
+	CONFIG_CACHE_FIELD( buildableAttributes_t, uniqueTest ),
+
+	CONFIG_CACHE_STRUCT( buildableModelConfig_t ),
+	CONFIG_CACHE_FIELD( buildableModelConfig_t, models ),
+	CONFIG_CACHE_FIELD( buildableModelConfig_t, modelScale ),
+	CONFIG_CACHE_FIELD( buildableModelConfig_t, modelRotation ),
+	CONFIG_CACHE_FIELD( buildableModelConfig_t, mins ),
+	CONFIG_CACHE_FIELD( buildableModelConfig_t, maxs ),
+	CONFIG_CACHE_FIELD( buildableModelConfig_t, zOffset ),
+	CONFIG_CACHE_FIELD( buildableModelConfig_t, oldScale ),
+	CONFIG_CACHE_FIELD( buildableModelConfig_t, oldOffset ),
+
+	CONFIG_CACHE_STRUCT( classAttributes_t ),
+	CONFIG_CACHE_FIELD( classAttributes_t, number ),
+	CONFIG_CACHE_FIELD( classAttributes_t, name ),
+	CONFIG_CACHE_FIELD( classAttributes_t, info ),
+	CONFIG_CACHE_FIELD( classAttributes_t, icon ),
+	CONFIG_CACHE_FIELD( classAttributes_t, fovCvar ),
+	CONFIG_CACHE_FIELD( classAttributes_t, team ),
+	CONFIG_CACHE_FIELD( classAttributes_t, unlockThreshold ),
+	CONFIG_CACHE_FIELD( classAttributes_t, health ),
+	CONFIG_CACHE_FIELD( classAttributes_t, fallDamage ),
+	CONFIG_CACHE_FIELD( classAttributes_t, regenRate ),
+	CONFIG_CACHE_FIELD( classAttributes_t, abilities ),
+	CONFIG_CACHE_FIELD( classAttributes_t, startWeapon ),
+	CONFIG_CACHE_FIELD( classAttributes_t, buildDist ),
+	CONFIG_CACHE_FIELD( classAttributes_t, fov ),
+	CONFIG_CACHE_FIELD( classAttributes_t, bob ),
+	CONFIG_CACHE_FIELD( classAttributes_t, bobCycle ),
+	CONFIG_CACHE_FIELD( classAttributes_t, steptime ),
+	CONFIG_CACHE_FIELD( classAttributes_t, speed ),
+	CONFIG_CACHE_FIELD( classAttributes_t, sprintMod ),
+	CONFIG_CACHE_FIELD( classAttributes_t, acceleration ),
+	CONFIG_CACHE_FIELD( classAttributes_t, airAcceleration ),
+	CONFIG_CACHE_FIELD( classAttributes_t, friction ),
+	CONFIG_CACHE_FIELD( classAttributes_t, stopSpeed ),
+	CONFIG_CACHE_FIELD( classAttributes_t, jumpMagnitude ),
+	CONFIG_CACHE_FIELD( classAttributes_t, mass ),
+	CONFIG_CACHE_FIELD( classAttributes_t, staminaJumpCost ),
+	CONFIG_CACHE_FIELD( classAttributes_t, staminaSprintCost ),
+	CONFIG_CACHE_FIELD( classAttributes_t, staminaJogRestore ),
+	CONFIG_CACHE_FIELD( classAttributes_t, staminaWalkRestore ),
+	CONFIG_CACHE_FIELD( classAttributes_t, staminaStopRestore ),
+	CONFIG_CACHE_FIELD( classAttributes_t, cost ),
+	CONFIG_CACHE_FIELD( classAttributes_t, value ),
+
+	CONFIG_CACHE_STRUCT( classModelConfig_t ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, modelName ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, modelScale ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, skinName ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, shadowScale ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, hudName ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, humanName ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, mins ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, maxs ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, crouchMaxs ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, deadMins ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, deadMaxs ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, viewheight ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, crouchViewheight ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, zOffset ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, shoulderOffsets ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, segmented ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, navMeshClass ),
+	CONFIG_CACHE_FIELD( classModelConfig_t, navHandle ),
+
+	CONFIG_CACHE_STRUCT( weaponAttributes_t ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, number ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, price ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, unlockThreshold ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, slots ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, name ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, humanName ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, info ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, maxAmmo ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, maxClips ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, infiniteAmmo ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, usesEnergy ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, repeatRate1 ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, repeatRate2 ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, repeatRate3 ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, reloadTime ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, knockbackScale ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, hasAltMode ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, hasThirdMode ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, canZoom ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, zoomFov ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, purchasable ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, longRanged ),
+	CONFIG_CACHE_FIELD( weaponAttributes_t, team ),
+
+	CONFIG_CACHE_STRUCT( upgradeAttributes_t ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, number ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, price ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, unlockThreshold ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, slots ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, name ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, humanName ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, info ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, icon ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, purchasable ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, usable ),
+	CONFIG_CACHE_FIELD( upgradeAttributes_t, team ),
+
+	CONFIG_CACHE_STRUCT( missileAttributes_t ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, number ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, name ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, pointAgainstWorld ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, damage ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, meansOfDeath ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, splashDamage ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, splashRadius ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, splashMeansOfDeath ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, clipmask ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, size ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, trajectoryType ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, speed ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, lag ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, flags ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, doKnockback ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, doLocationalDamage ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, model ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, modelScale ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, modelRotation ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, sound ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, usesDlight ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, dlight ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, dlightIntensity ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, dlightColor ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, renderfx ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, usesSprite ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, sprite ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, spriteSize ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, spriteCharge ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, particleSystem ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, trailSystem ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, rotates ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, usesAnim ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, animStartFrame ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, animNumFrames ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, animFrameRate ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, animLooping ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, alwaysImpact ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, impactParticleSystem ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, impactFlightDirection ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, usesImpactMark ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, impactMark ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, impactMarkSize ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, impactSound ),
+	CONFIG_CACHE_FIELD( missileAttributes_t, impactFleshSound ),
+};
+
+// Changes whenever a field of one of the cached structures is added, removed,
+// moved or resized
+static uint64_t ConfigCacheLayout()
+{
+	std::string layout;
+
+	for ( const configCacheField_t &field : configCacheFields )
+	{
+		layout += va( "%s %d %d;", field.name, ( int ) field.offset, ( int ) field.size );
+	}
+
+	return ConfigCacheHash( layout.data(), layout.size() );
+}
+
+/*
+======================
+Serialization helpers
+======================
+*/
+
+static void WriteInt( std::string &out, int32_t value )
+{
+	out.append( ( const char * ) &value, sizeof( value ) );
+}
+
+static void WriteHash( std::string &out, uint64_t value )
+{
+	out.append( ( const char * ) &value, sizeof( value ) );
+}
+
+static void WriteString( std::string &out, const char *str )
+{
+	int32_t length = strlen( str );
+
+	WriteInt( out, length );
+	out.append( str, length );
+}
+
+class ConfigCacheReader
+{
+public:
+	ConfigCacheReader( const std::string &data, size_t pos ) : data( data ), pos( pos ), ok( true ) { }
+
+	bool Read( void *out, size_t size )
+	{
+		if ( !ok || pos + size > data.size() )
+		{
+			ok = false;
+			return false;
+		}
+
+		memcpy( out, data.data() + pos, size );
+		pos += size;
+		return true;
+	}
+
+	int32_t ReadInt()
+	{
+		int32_t value = 0;
+		Read( &value, sizeof( value ) );
+		return value;
+	}
+
+	uint64_t ReadHash()
+	{
+		uint64_t value = 0;
+		Read( &value, sizeof( value ) );
+		return value;
+	}
+
+	std::string ReadString()
+	{
+		int32_t length = ReadInt();
+
+		if ( !ok || length < 0 || pos + length > data.size() )
+		{
+			ok = false;
+			return "";
+		}
+
+		pos += length;
+		return data.substr( pos - length, length );
+	}
+
+	const std::string &data;
+	size_t pos;
+	bool ok;
+};
+
+/*
+======================
+Cache validation
+======================
+*/
+
+static bool ConfigCacheSourceIsCurrent( const std::string &name, int32_t length, bool read, uint64_t hash )
+{
+	fileHandle_t f;
+	int len = trap_FS_FOpenFile( name.c_str(), &f, fsMode_t::FS_READ );
+
+	if ( len < 0 || length < 0 )
+	{
+		if ( len >= 0 )
+		{
+			trap_FS_FCloseFile( f );
+		}
+
+		return len < 0 && length < 0;
+	}
+
+	if ( len != length )
+	{
+		trap_FS_FCloseFile( f );
+		return false;
+	}
+
+	if ( !read )
+	{
+		trap_FS_FCloseFile( f );
+		return true;
+	}
+
+	std::string text( len, '\0' );
+	trap_FS_Read( &text[ 0 ], len, f );
+	trap_FS_FCloseFile( f );
+
+	return ConfigCacheHash( text.data(), len ) == hash;
+}
+
+static bool ConfigCacheLoad()
+{
+	fileHandle_t f;
+	int len = trap_FS_FOpenFile( CONFIG_CACHE_FILE, &f, fsMode_t::FS_READ );
+
+	if ( len <= 0 )
+	{
+		if ( len == 0 )
+		{
+			trap_FS_FCloseFile( f );
+		}
+
+		return false;
+	}
+
+	cache.records.assign( len, '\0' );
+	trap_FS_Read( &cache.records[ 0 ], len, f );
+	trap_FS_FCloseFile( f );
+
+	ConfigCacheReader reader( cache.records, 0 );
+
+	if ( reader.ReadInt() != CONFIG_CACHE_MAGIC ||
+	     reader.ReadInt() != CONFIG_CACHE_VERSION ||
+	     reader.ReadString() != ConfigCacheBuild() ||
+	     reader.ReadHash() != ConfigCacheLayout() )
+	{
+		return false;
+	}
+
+	int numSources = reader.ReadInt();
+	int numRecords = reader.ReadInt();
+
+	for ( int i = 0; i < numSources && reader.ok; i++ )
+	{
+		std::string name = reader.ReadString();
+		int32_t length = reader.ReadInt();
+		bool read = reader.ReadInt();
+		uint64_t hash = reader.ReadHash();
+
+		if ( !reader.ok || !ConfigCacheSourceIsCurrent( name, length, read, hash ) )
+		{
+			return false;
+		}
+	}
+
+	for ( int i = 0; i < numRecords && reader.ok; i++ )
+	{
+		std::string name = reader.ReadString();
+		int32_t size = reader.ReadInt();
+		int32_t numStrings;
+
+		cache.recordOffsets[ name ] = reader.pos;
+
+		reader.pos += size;
+		numStrings = reader.ReadInt();
+
+		for ( int j = 0; j < numStrings && reader.ok; j++ )
+		{
+			if ( reader.ReadInt() == CCS_OWNED )
+			{
+				reader.ReadString();
+			}
+		}
+	}
+
+	return reader.ok && reader.pos == cache.records.size();
+}
+
+/*
+======================
+BG_ConfigCacheBegin
+
+Returns true if a cache matching the current configuration files was found,
+in which case BG_ConfigCacheRestore can be used. Otherwise, the records
+passed to BG_ConfigCacheStore are collected to write a new cache.
+======================
+*/
+bool BG_ConfigCacheBegin()
+{
+	cache.broken = false;
+	cache.sources.clear();
+	cache.numSources = 0;
+	cache.sourceNames.clear();
+	cache.records.clear();
+	cache.numRecords = 0;
+	cache.recordOffsets.clear();
+
+	if ( ConfigCacheLoad() )
+	{
+		cache.mode = configCacheMode_t::READING;
+		return true;
+	}
+
+	BG_ConfigCacheDiscard();
+	return false;
+}
+
+/*
+======================
+BG_ConfigCacheDiscard
+
+Stops using the cache being read, everything is parsed and stored again.
+======================
+*/
+void BG_ConfigCacheDiscard()
+{
+	cache.mode = configCacheMode_t::WRITING;
+	cache.records.clear();
+	cache.recordOffsets.clear();
+}
+
+/*
+======================
+BG_ConfigCacheEnd
+
+Writes the cache if it was rebuilt.
+======================
+*/
+void BG_ConfigCacheEnd()
+{
+	if ( cache.mode == configCacheMode_t::WRITING && !cache.broken )
+	{
+		std::string out;
+		fileHandle_t f;
+
+		WriteInt( out, CONFIG_CACHE_MAGIC );
+		WriteInt( out, CONFIG_CACHE_VERSION );
+		WriteString( out, ConfigCacheBuild().c_str() );
+		WriteHash( out, ConfigCacheLayout() );
+		WriteInt( out, cache.numSources );
+		WriteInt( out, cache.numRecords );
+		out += cache.sources;
+		out += cache.records;
+
+		if ( trap_FS_FOpenFile( CONFIG_CACHE_FILE, &f, fsMode_t::FS_WRITE ) >= 0 )
+		{
+			trap_FS_Write( out.data(), out.size(), f );
+			trap_FS_FCloseFile( f );
+		}
+		else
+		{
+			Log::Warn( "could not write the config cache %s", CONFIG_CACHE_FILE );
+		}
+	}
+
+	cache.mode = configCacheMode_t::IDLE;
+	cache.sources.clear();
+	cache.sourceNames.clear();
+	cache.records.clear();
+	cache.recordOffsets.clear();
+}
+
+/*
+======================
+BG_ConfigCacheSource
+
+Called by BG_ReadWholeFile for every file it opens. text is null if the file
+could not be read, and length is negative if it does not exist.
+======================
+*/
+void BG_ConfigCacheSource( const char *filename, const char *text, int length )
+{
+	if ( cache.mode != configCacheMode_t::WRITING || cache.sourceNames.count( filename ) )
+	{
+		return;
+	}
+
+	cache.sourceNames.insert( filename );
+
+	WriteString( cache.sources, filename );
+	WriteInt( cache.sources, length < 0 ? -1 : length );
+	WriteInt( cache.sources, text != nullptr );
+	WriteHash( cache.sources, text ? ConfigCacheHash( text, length ) : 0 );
+	cache.numSources++;
+}
+
+/*
+======================
+BG_ConfigCacheStore
+
+Adds a parsed record to the cache being written.
+======================
+*/
+void BG_ConfigCacheStore( const char *name, const void *record, size_t size,
+                          const configCacheString_t *strings, size_t numStrings )
+{
+	if ( cache.mode != configCacheMode_t::WRITING )
+	{
+		return;
+	}
+
+	WriteString( cache.records, name );
+	WriteInt( cache.records, size );
+	cache.records.append( ( const char * ) record, size );
+	WriteInt( cache.records, numStrings );
+
+	for ( size_t i = 0; i < numStrings; i++ )
+	{
+		const char *str = *( const char * const * )( ( const char * ) record + strings[ i ].offset );
+
+		if ( strings[ i ].type == CCS_STATIC )
+		{
+			WriteInt( cache.records, CCS_STATIC );
+		}
+		else if ( !str )
+		{
+			WriteInt( cache.records, CONFIG_CACHE_NULL );
+		}
+		else
+		{
+			WriteInt( cache.records, CCS_OWNED );
+			WriteString( cache.records, str );
+		}
+	}
+
+	cache.numRecords++;
+}
+
+/*
+======================
+BG_ConfigCacheRestore
+
+Fills a record from the cache. Static strings keep the value they have in
+the record, owned strings are allocated again. Returns false if the record
+is not cached, in which case it has to be parsed.
+======================
+*/
+bool BG_ConfigCacheRestore( const char *name, void *record, size_t size,
+                            const configCacheString_t *strings, size_t numStrings )
+{
+	if ( cache.mode != configCacheMode_t::READING )
+	{
+		return false;
+	}
+
+	auto it = cache.recordOffsets.find( name );
+
+	if ( it == cache.recordOffsets.end() )
+	{
+		Log::Warn( "config cache: no record for %s", name );
+		return false;
+	}
+
+	ConfigCacheReader        reader( cache.records, it->second - sizeof( int32_t ) );
+	std::string              data;
+	std::vector<int32_t>     types( numStrings );
+	std::vector<std::string> values( numStrings );
+
+	if ( reader.ReadInt() != ( int32_t ) size || reader.pos + size > cache.records.size() )
+	{
+		Log::Warn( "config cache: record %s has the wrong size", name );
+		return false;
+	}
+
+	data.assign( cache.records, reader.pos, size );
+	reader.pos += size;
+
+	if ( reader.ReadInt() != ( int32_t ) numStrings )
+	{
+		Log::Warn( "config cache: record %s has the wrong layout", name );
+		return false;
+	}
+
+	// decode the whole record before touching the caller's, which is parsed if this fails
+	for ( size_t i = 0; i < numStrings; i++ )
+	{
+		types[ i ] = reader.ReadInt();
+
+		if ( types[ i ] == CCS_OWNED )
+		{
+			values[ i ] = reader.ReadString();
+		}
+		else if ( types[ i ] != CCS_STATIC && types[ i ] != CONFIG_CACHE_NULL )
+		{
+			reader.ok = false;
+		}
+	}
+
+	if ( !reader.ok )
+	{
+		Log::Warn( "config cache: record %s is corrupt", name );
+		return false;
+	}
+
+	// keep the static strings the record was initialized with
+	for ( size_t i = 0; i < numStrings; i++ )
+	{
+		memcpy( &data[ strings[ i ].offset ], ( const char * ) record + strings[ i ].offset, sizeof( char * ) );
+	}
+
+	memcpy( record, data.data(), size );
+
+	for ( size_t i = 0; i < numStrings; i++ )
+	{
+		const char **field = ( const char ** )( ( char * ) record + strings[ i ].offset );
+
+		if ( types[ i ] == CCS_STATIC )
+		{
+			continue;
+		}
+		else if ( types[ i ] != CCS_OWNED )
+		{
+			*field = nullptr;
+		}
+		else if ( values[ i ].empty() && strings[ i ].type == CCS_OWNED_OR_EMPTY )
+		{
+			*field = "";
+		}
+		else
+		{
+			*field = BG_strdup( values[ i ].c_str() );
+		}
+	}
+
+	return true;
+}
@@ -38,6 +38,7 @@ void                               trap_FS_FCloseFile( fileHandle_t f );
 void                               trap_FS_Seek( fileHandle_t f, long offset, fsOrigin_t origin );  // fsOrigin_t
 int                                trap_FS_GetFileList( const char *path, const char *extension, char *listbuf, int bufsize );
 void                               trap_QuoteString( const char *, char *, int );
+int                                trap_Milliseconds();
 
 typedef struct
 {
@@ -120,6 +121,16 @@ const buildableAttributes_t *BG_Buildable( int buildable )
 	       &bg_buildableList[ buildable - 1 ] : &nullBuildable;
 }
 
+// strings of the attribute structures, for the config cache
+static const configCacheString_t buildableStrings[] =
+{
+	{ offsetof( buildableAttributes_t, name ),       CCS_STATIC },
+	{ offsetof( buildableAttributes_t, humanName ),  CCS_OWNED },
+	{ offsetof( buildableAttributes_t, info ),       CCS_OWNED },
+	{ offsetof( buildableAttributes_t, entityName ), CCS_STATIC },
+	{ offsetof( buildableAttributes_t, icon ),       CCS_OWNED },
+};
+
 /*
 ===============
 BG_InitBuildableAttributes
@@ -146,7 +157,13 @@ void BG_InitBuildableAttributes()
 		ba->bounce = 0.0;
 		ba->minNormal = 0.0;
 
-		BG_ParseBuildableAttributeFile( va( "configs/buildables/%s.attr.cfg", ba->name ), ba );
+		const char *filename = va( "configs/buildables/%s.attr.cfg", ba->name );
+
+		if ( !BG_ConfigCacheRestore( filename, ba, sizeof( *ba ), buildableStrings, ARRAY_LEN( buildableStrings ) ) )
+		{
+			BG_ParseBuildableAttributeFile( filename, ba );
+			BG_ConfigCacheStore( filename, ba, sizeof( *ba ), buildableStrings, ARRAY_LEN( buildableStrings ) );
+		}
 	}
 }
 
@@ -198,8 +215,13 @@ void BG_InitBuildableModelConfigs()
 		bc = BG_BuildableModelConfig( i );
 		Com_Memset( bc, 0, sizeof( buildableModelConfig_t ) );
 
-		BG_ParseBuildableModelFile( va( "configs/buildables/%s.model.cfg",
-		                           BG_Buildable( i )->name ), bc );
+		const char *filename = va( "configs/buildables/%s.model.cfg", BG_Buildable( i )->name );
+
+		if ( !BG_ConfigCacheRestore( filename, bc, sizeof( *bc ), nullptr, 0 ) )
+		{
+			BG_ParseBuildableModelFile( filename, bc );
+			BG_ConfigCacheStore( filename, bc, sizeof( *bc ), nullptr, 0 );
+		}
 	}
 }
 
@@ -507,6 +529,19 @@ int BG_GetBarbRegenerationInterval(const playerState_t& ps)
 	}
 }
 
+static const configCacheString_t classStrings[] =
+{
+	{ offsetof( classAttributes_t, name ),    CCS_STATIC },
+	{ offsetof( classAttributes_t, info ),    CCS_OWNED_OR_EMPTY },
+	{ offsetof( classAttributes_t, icon ),    CCS_OWNED },
+	{ offsetof( classAttributes_t, fovCvar ), CCS_OWNED_OR_EMPTY },
+};
+
+static const configCacheString_t classModelStrings[] =
+{
+	{ offsetof( classModelConfig_t, humanName ), CCS_OWNED },
+};
+
 /*
 ===============
 BG_InitClassAttributes
@@ -531,7 +566,13 @@ void BG_InitClassAttributes()
 		ca->bobCycle = 0.0f;
 		ca->abilities = 0;
 
-		BG_ParseClassAttributeFile( va( "configs/classes/%s.attr.cfg", ca->name ), ca );
+		const char *filename = va( "configs/classes/%s.attr.cfg", ca->name );
+
+		if ( !BG_ConfigCacheRestore( filename, ca, sizeof( *ca ), classStrings, ARRAY_LEN( classStrings ) ) )
+		{
+			BG_ParseClassAttributeFile( filename, ca );
+			BG_ConfigCacheStore( filename, ca, sizeof( *ca ), classStrings, ARRAY_LEN( classStrings ) );
+		}
 	}
 }
 
@@ -545,11 +586,16 @@ void BG_InitClassModelConfigs()
 	for ( int i = PCL_NONE; i < PCL_NUM_CLASSES; i++ )
 	{
 		classModelConfig_t *cc = BG_ClassModelConfig( i );
+		const char *filename = va( "configs/classes/%s.model.cfg", BG_Class( i )->name );
 
-		BG_ParseClassModelFile( va( "configs/classes/%s.model.cfg",
-		                       BG_Class( i )->name ), cc );
+		if ( !BG_ConfigCacheRestore( filename, cc, sizeof( *cc ), classModelStrings, ARRAY_LEN( classModelStrings ) ) )
+		{
+			BG_ParseClassModelFile( filename, cc );
 
-		cc->segmented = cc->modelName[0] && BG_NonSegModel( va( "models/players/%s/animation.cfg", cc->modelName ) );
+			cc->segmented = cc->modelName[0] && BG_NonSegModel( va( "models/players/%s/animation.cfg", cc->modelName ) );
+
+			BG_ConfigCacheStore( filename, cc, sizeof( *cc ), classModelStrings, ARRAY_LEN( classModelStrings ) );
+		}
 	}
 }
 
@@ -633,6 +679,13 @@ const weaponAttributes_t *BG_Weapon( int weapon )
 	       &bg_weapons[ weapon - 1 ] : &nullWeapon;
 }
 
+static const configCacheString_t weaponStrings[] =
+{
+	{ offsetof( weaponAttributes_t, name ),      CCS_STATIC },
+	{ offsetof( weaponAttributes_t, humanName ), CCS_OWNED },
+	{ offsetof( weaponAttributes_t, info ),      CCS_OWNED_OR_EMPTY },
+};
+
 /*
 ===============
 BG_InitWeaponAttributes
@@ -656,7 +709,13 @@ void BG_InitWeaponAttributes()
 		// set default values for optional fields
 		wa->knockbackScale = 1.0f;
 
-		BG_ParseWeaponAttributeFile( va( "configs/weapon/%s.attr.cfg", wa->name ), wa );
+		const char *filename = va( "configs/weapon/%s.attr.cfg", wa->name );
+
+		if ( !BG_ConfigCacheRestore( filename, wa, sizeof( *wa ), weaponStrings, ARRAY_LEN( weaponStrings ) ) )
+		{
+			BG_ParseWeaponAttributeFile( filename, wa );
+			BG_ConfigCacheStore( filename, wa, sizeof( *wa ), weaponStrings, ARRAY_LEN( weaponStrings ) );
+		}
 	}
 }
 
@@ -721,6 +780,14 @@ const upgradeAttributes_t *BG_Upgrade( int upgrade )
 	       &bg_upgrades[ upgrade - 1 ] : &nullUpgrade;
 }
 
+static const configCacheString_t upgradeStrings[] =
+{
+	{ offsetof( upgradeAttributes_t, name ),      CCS_STATIC },
+	{ offsetof( upgradeAttributes_t, humanName ), CCS_OWNED },
+	{ offsetof( upgradeAttributes_t, info ),      CCS_OWNED_OR_EMPTY },
+	{ offsetof( upgradeAttributes_t, icon ),      CCS_OWNED },
+};
+
 /*
 ===============
 BG_InitUpgradeAttributes
@@ -742,7 +809,13 @@ void BG_InitUpgradeAttributes()
 		ua->number = ud->number;
 		ua->name = ud->name;
 
-		BG_ParseUpgradeAttributeFile( va( "configs/upgrades/%s.attr.cfg", ua->name ), ua );
+		const char *filename = va( "configs/upgrades/%s.attr.cfg", ua->name );
+
+		if ( !BG_ConfigCacheRestore( filename, ua, sizeof( *ua ), upgradeStrings, ARRAY_LEN( upgradeStrings ) ) )
+		{
+			BG_ParseUpgradeAttributeFile( filename, ua );
+			BG_ConfigCacheStore( filename, ua, sizeof( *ua ), upgradeStrings, ARRAY_LEN( upgradeStrings ) );
+		}
 	}
 }
 
@@ -805,6 +878,11 @@ const missileAttributes_t *BG_Missile( int missile )
 	       &bg_missiles[ missile - 1 ] : &nullMissile;
 }
 
+static const configCacheString_t missileStrings[] =
+{
+	{ offsetof( missileAttributes_t, name ), CCS_STATIC },
+};
+
 /*
 ===============
 BG_InitMissileAttributes
@@ -826,8 +904,16 @@ void BG_InitMissileAttributes()
 		ma->number = md->number;
 
 		// for simplicity, read both from a single file
-		BG_ParseMissileAttributeFile( va( "configs/missiles/%s.missile.cfg", ma->name ), ma );
-		BG_ParseMissileDisplayFile(   va( "configs/missiles/%s.missile.cfg", ma->name ), ma );
+		const char *filename = va( "configs/missiles/%s.missile.cfg", ma->name );
+
+		// only the attributes are cached, the display part holds renderer handles
+		if ( !BG_ConfigCacheRestore( filename, ma, sizeof( *ma ), missileStrings, ARRAY_LEN( missileStrings ) ) )
+		{
+			BG_ParseMissileAttributeFile( filename, ma );
+			BG_ConfigCacheStore( filename, ma, sizeof( *ma ), missileStrings, ARRAY_LEN( missileStrings ) );
+		}
+
+		BG_ParseMissileDisplayFile( filename, ma );
 	}
 }
 
@@ -1009,17 +1095,60 @@ bool config_loaded = false;
 
 void BG_InitAllConfigs()
 {
-	BG_InitBuildableAttributes();
-	BG_InitBuildableModelConfigs();
-	BG_InitClassAttributes();
-	BG_InitClassModelConfigs();
-	BG_InitWeaponAttributes();
-	BG_InitUpgradeAttributes();
-	BG_InitMissileAttributes();
-	BG_InitBeaconAttributes();
+	static const struct
+	{
+		const char *name;
+		void ( *init )();
+	} steps[] =
+	{
+		{ "buildable attributes", BG_InitBuildableAttributes },
+		{ "buildable models",     BG_InitBuildableModelConfigs },
+		{ "class attributes",     BG_InitClassAttributes },
+		{ "class models",         BG_InitClassModelConfigs },
+		{ "weapon attributes",    BG_InitWeaponAttributes },
+		{ "upgrade attributes",   BG_InitUpgradeAttributes },
+		{ "missile attributes",   BG_InitMissileAttributes },
+		{ "beacon attributes",    BG_InitBeaconAttributes },
+	};
+	int times[ ARRAY_LEN( steps ) ];
+	int start = trap_Milliseconds();
+	bool cached = BG_ConfigCacheBegin();
+
+	// the config vars are set as a side effect of parsing, so they have to be
+	// available before anything is taken from the cache
+	if ( cached && !BG_RestoreConfigVars() )
+	{
+		BG_ConfigCacheDiscard();
+		cached = false;
+	}
+
+	for ( unsigned i = 0; i < ARRAY_LEN( steps ); i++ )
+	{
+		int stepStart = trap_Milliseconds();
+		steps[ i ].init();
+		times[ i ] = trap_Milliseconds() - stepStart;
+	}
+
+	if ( !cached )
+	{
+		BG_StoreConfigVars();
+	}
+
+	BG_ConfigCacheEnd();
 
 	BG_CheckConfigVars();
 
+	if ( atoi( Cvar::GetValue( "developer" ).c_str() ) )
+	{
+		Log::Notice( "gameplay configs loaded in %dms (config cache %s)",
+		             trap_Milliseconds() - start, cached ? "hit" : "miss" );
+
+		for ( unsigned i = 0; i < ARRAY_LEN( steps ); i++ )
+		{
+			Log::Notice( "  %-20s %dms", steps[ i ].name, times[ i ] );
+		}
+	}
+
 	config_loaded = true;
 }
 
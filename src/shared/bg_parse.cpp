@@ -334,12 +334,14 @@ bool BG_ReadWholeFile( const char *filename, char *buffer, int size)
 
 	if ( len < 0 )
 	{
+		BG_ConfigCacheSource( filename, nullptr, -1 );
 		Log::Warn( "file %s doesn't exist", filename );
 		return false;
 	}
 
 	if ( len == 0 || len >= size - 1 )
 	{
+		BG_ConfigCacheSource( filename, nullptr, len );
 		trap_FS_FCloseFile( f );
 		Log::Warn( "file %s is %s", filename,
 					len == 0 ? "empty" : "too long" );
@@ -350,6 +352,8 @@ bool BG_ReadWholeFile( const char *filename, char *buffer, int size)
 	buffer[ len ] = 0;
 	trap_FS_FCloseFile( f );
 
+	BG_ConfigCacheSource( filename, buffer, len );
+
 	return true;
 }
 
@@ -567,6 +571,59 @@ bool BG_CheckConfigVars()
 	return ok;
 }
 
+typedef struct
+{
+	int32_t value; // int or float, see configVarType_t
+	int32_t defined;
+} configVarValue_t;
+
+#define CONFIG_VARS_RECORD "configVars"
+
+/*
+======================
+BG_StoreConfigVars
+
+Adds the config vars set while parsing to the config cache.
+======================
+*/
+void BG_StoreConfigVars()
+{
+	configVarValue_t values[ bg_numConfigVars ];
+
+	for ( unsigned i = 0; i < bg_numConfigVars; i++ )
+	{
+		memcpy( &values[ i ].value, bg_configVars[ i ].var, sizeof( values[ i ].value ) );
+		values[ i ].defined = bg_configVars[ i ].defined;
+	}
+
+	BG_ConfigCacheStore( CONFIG_VARS_RECORD, values, sizeof( values ), nullptr, 0 );
+}
+
+/*
+======================
+BG_RestoreConfigVars
+
+Sets the config vars from the config cache.
+======================
+*/
+bool BG_RestoreConfigVars()
+{
+	configVarValue_t values[ bg_numConfigVars ];
+
+	if ( !BG_ConfigCacheRestore( CONFIG_VARS_RECORD, values, sizeof( values ), nullptr, 0 ) )
+	{
+		return false;
+	}
+
+	for ( unsigned i = 0; i < bg_numConfigVars; i++ )
+	{
+		memcpy( bg_configVars[ i ].var, &values[ i ].value, sizeof( values[ i ].value ) );
+		bg_configVars[ i ].defined = values[ i ].defined;
+	}
+
+	return true;
+}
+
 /*
 ======================
 BG_ParseBuildableAttributeFile
@@ -5138,53 +5138,88 @@ void PmoveSingle( pmove_t *pmove )
 
 /*
 ================
-Pmove
+PmoveBegin
 
-Can be called by either the server or the client
+Sets up a move, returns false if the command is older than the player state.
 ================
 */
-void Pmove( pmove_t *pmove )
+bool PmoveBegin( pmove_t *pmove, int *finalTime )
 {
-	int finalTime;
+	*finalTime = pmove->cmd.serverTime;
 
-	finalTime = pmove->cmd.serverTime;
-
-	if ( finalTime < pmove->ps->commandTime )
+	if ( *finalTime < pmove->ps->commandTime )
 	{
-		return; // should not happen
+		return false; // should not happen
 	}
 
-	if ( finalTime > pmove->ps->commandTime + 1000 )
+	if ( *finalTime > pmove->ps->commandTime + 1000 )
 	{
-		pmove->ps->commandTime = finalTime - 1000;
+		pmove->ps->commandTime = *finalTime - 1000;
 	}
 
 	pmove->ps->pmove_framecount = ( pmove->ps->pmove_framecount + 1 ) & ( ( 1 << PS_PMOVEFRAMECOUNTBITS ) - 1 );
 
-	// chop the move up if it is too long, to prevent framerate
-	// dependent behavior
-	while ( pmove->ps->commandTime != finalTime )
+	return true;
+}
+
+/*
+================
+PmoveNextStep
+
+Sets the time of the next PmoveSingle of a move, returns false once the move
+is over.
+================
+*/
+bool PmoveNextStep( pmove_t *pmove, int finalTime )
+{
+	int msec;
+
+	if ( pmove->ps->commandTime == finalTime )
 	{
-		int msec;
+		return false;
+	}
 
-		msec = finalTime - pmove->ps->commandTime;
+	// chop the move up if it is too long, to prevent framerate
+	// dependent behavior
+	msec = finalTime - pmove->ps->commandTime;
 
-		if ( pmove->pmove_fixed )
+	if ( pmove->pmove_fixed )
+	{
+		if ( msec > pmove->pmove_msec )
 		{
-			if ( msec > pmove->pmove_msec )
-			{
-				msec = pmove->pmove_msec;
-			}
+			msec = pmove->pmove_msec;
 		}
-		else
+	}
+	else
+	{
+		if ( msec > 66 )
 		{
-			if ( msec > 66 )
-			{
-				msec = 66;
-			}
+			msec = 66;
 		}
+	}
+
+	pmove->cmd.serverTime = pmove->ps->commandTime + msec;
+	return true;
+}
+
+/*
+================
+Pmove
 
-		pmove->cmd.serverTime = pmove->ps->commandTime + msec;
+Can be called by either the server or the client
+================
+*/
+void Pmove( pmove_t *pmove )
+{
+	int finalTime;
+
+	if ( !PmoveBegin( pmove, &finalTime ) )
+	{
+		return;
+	}
+
+	while ( PmoveNextStep( pmove, finalTime ) )
+	{
 		PmoveSingle( pmove );
 	}
 }
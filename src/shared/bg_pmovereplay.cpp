@@ -0,0 +1,168 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2016 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished.  If not, see <http://www.gnu.org/licenses/>.
+
+===========================================================================
+*/
+
+// bg_pmovereplay.cpp -- replay of recorded player moves
+
+/*
+The sgame records the input and the output of the Pmove of its clients (see
+g_pmoveRecord). BG_PmoveReplay runs the recorded inputs through Pmove again,
+one PmoveSingle at a time so each of them can be timed, and compares the
+outputs with the recorded ones. It is used by the pmoveReplay server command,
+which traces against the running game, and by the standalone pmovereplay
+program, which only loads the collision data of the map.
+
+The records are raw structures and can only be replayed by builds sharing
+their layout, which is checked with the header.
+*/
+
+#include "engine/qcommon/q_shared.h"
+#include "bg_public.h"
+
+#include <chrono>
+
+/*
+======================
+BG_PmoveRecordHeader
+======================
+*/
+void BG_PmoveRecordHeader( pmoveRecordHeader_t *header, const char *mapname )
+{
+	memset( header, 0, sizeof( *header ) );
+	memcpy( header->magic, "PMRC", 4 );
+	header->version = PMOVE_RECORD_VERSION;
+	header->playerStateSize = sizeof( playerState_t );
+	header->pmoveExtSize = sizeof( pmoveExt_t );
+	header->usercmdSize = sizeof( usercmd_t );
+	Q_strncpyz( header->mapname, mapname, sizeof( header->mapname ) );
+}
+
+/*
+======================
+BG_PmoveRecordCompatible
+
+Returns whether the records following the header can be replayed by this build.
+======================
+*/
+bool BG_PmoveRecordCompatible( const pmoveRecordHeader_t *header )
+{
+	pmoveRecordHeader_t expected;
+
+	BG_PmoveRecordHeader( &expected, "" );
+
+	return !memcmp( header->magic, expected.magic, 4 ) && header->version == expected.version &&
+	       header->playerStateSize == expected.playerStateSize && header->pmoveExtSize == expected.pmoveExtSize &&
+	       header->usercmdSize == expected.usercmdSize;
+}
+
+static uint32_t BG_PmoveReplayHash( uint32_t hash, const void *data, size_t size )
+{
+	for ( size_t i = 0; i < size; i++ )
+	{
+		hash = ( hash ^ ( ( const byte * ) data )[ i ] ) * 16777619u;
+	}
+
+	return hash;
+}
+
+/*
+======================
+BG_PmoveReplay
+
+Replays the records iterations times. The outputs are only compared and
+hashed on the first iteration, the hash covers the player state and the
+pmove extension of every move.
+======================
+*/
+void BG_PmoveReplay( const pmoveRecord_t *records, int numRecords, int iterations,
+                     void ( *trace )( trace_t *, const vec3_t, const vec3_t, const vec3_t,
+                                      const vec3_t, int, int, int ),
+                     int ( *pointcontents )( const vec3_t, int ),
+                     pmoveReplayResult_t *result )
+{
+	std::chrono::steady_clock::duration spent = std::chrono::steady_clock::duration::zero();
+
+	memset( result, 0, sizeof( *result ) );
+	result->moves = numRecords;
+	result->firstMismatch = -1;
+	result->hash = 2166136261u;
+
+	for ( int iteration = 0; iteration < iterations; iteration++ )
+	{
+		for ( int i = 0; i < numRecords; i++ )
+		{
+			const pmoveRecord_t *record = &records[ i ];
+			playerState_t       ps = record->psIn;
+			pmoveExt_t          pmext = record->pmextIn;
+			pmove_t             pm;
+			int                 finalTime;
+
+			memset( &pm, 0, sizeof( pm ) );
+			pm.ps = &ps;
+			pm.pmext = &pmext;
+			pm.cmd = record->cmd;
+			pm.tracemask = record->tracemask;
+			pm.trace = trace;
+			pm.pointcontents = pointcontents;
+			pm.pmove_fixed = record->pmoveFixed;
+			pm.pmove_msec = record->pmoveMsec;
+			pm.pmove_accurate = record->pmoveAccurate;
+
+			if ( PmoveBegin( &pm, &finalTime ) )
+			{
+				while ( PmoveNextStep( &pm, finalTime ) )
+				{
+					auto start = std::chrono::steady_clock::now();
+
+					PmoveSingle( &pm );
+					spent += std::chrono::steady_clock::now() - start;
+
+					if ( iteration == 0 )
+					{
+						result->steps++;
+					}
+				}
+			}
+
+			if ( iteration > 0 )
+			{
+				continue;
+			}
+
+			if ( memcmp( &ps, &record->psOut, sizeof( ps ) ) || memcmp( &pmext, &record->pmextOut, sizeof( pmext ) ) )
+			{
+				if ( result->firstMismatch < 0 )
+				{
+					result->firstMismatch = i;
+				}
+
+				result->mismatches++;
+			}
+
+			result->hash = BG_PmoveReplayHash( result->hash, &ps, sizeof( ps ) );
+			result->hash = BG_PmoveReplayHash( result->hash, &pmext, sizeof( pmext ) );
+		}
+	}
+
+	result->nanoseconds = std::chrono::duration<double, std::nano>( spent ).count();
+}
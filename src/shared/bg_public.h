@@ -221,6 +221,11 @@ typedef struct pmove_s
 void PM_UpdateViewAngles( playerState_t *ps, const usercmd_t *cmd );
 void Pmove( pmove_t *pmove );
 
+// the steps of Pmove, for the replay to time each PmoveSingle
+bool PmoveBegin( pmove_t *pmove, int *finalTime );
+bool PmoveNextStep( pmove_t *pmove, int finalTime );
+void PmoveSingle( pmove_t *pmove );
+
 //===================================================================================
 
 // player_state->stats[] indexes
@@ -1348,6 +1353,9 @@ void     BG_BuildEntityDescription( char *str, size_t size, entityState_t *es );
 bool     BG_IsMainStructure( buildable_t buildable );
 bool     BG_IsMainStructure( entityState_t *es );
 void     BG_MoveOriginToBBOXCenter( vec3_t point, const vec3_t mins, const vec3_t maxs );
+int      BG_GridCell( float coord, float origin, float cellSize );
+void     BG_GridCells( const vec3_t origin, float cellSize, const vec3_t mins, const vec3_t maxs, int cells[ 4 ] );
+uint32_t BG_GridCellKey( int x, int y );
 void     ModifyFlag(int &flags, int flag, bool value);
 void     AddFlag(int &flags, int flag);
 void     RemoveFlag(int &flags, int flag);
@@ -1424,6 +1432,8 @@ void                      BG_UnloadAllConfigs();
 // Parsers
 bool                  BG_ReadWholeFile( const char *filename, char *buffer, int size);
 bool                  BG_CheckConfigVars();
+void                      BG_StoreConfigVars();
+bool                      BG_RestoreConfigVars();
 bool                  BG_NonSegModel( const char *filename );
 void                      BG_ParseBuildableAttributeFile( const char *filename, buildableAttributes_t *ba );
 void                      BG_ParseBuildableModelFile( const char *filename, buildableModelConfig_t *bc );
@@ -1435,6 +1445,74 @@ void                      BG_ParseMissileAttributeFile( const char *filename, mi
 void                      BG_ParseMissileDisplayFile( const char *filename, missileAttributes_t *ma );
 void                      BG_ParseBeaconAttributeFile( const char *filename, beaconAttributes_t *ba );
 
+// bg_configcache.cpp
+typedef enum
+{
+  CCS_STATIC,         // not owned by the record, the current value is kept
+  CCS_OWNED,          // allocated with BG_strdup
+  CCS_OWNED_OR_EMPTY  // allocated with BG_strdup, or the "" literal when empty
+} configCacheStringType_t;
+
+typedef struct
+{
+	size_t                  offset;
+	configCacheStringType_t type;
+} configCacheString_t;
+
+bool                      BG_ConfigCacheBegin();
+void                      BG_ConfigCacheDiscard();
+void                      BG_ConfigCacheEnd();
+void                      BG_ConfigCacheSource( const char *filename, const char *text, int length );
+void                      BG_ConfigCacheStore( const char *name, const void *record, size_t size,
+                                               const configCacheString_t *strings, size_t numStrings );
+bool                      BG_ConfigCacheRestore( const char *name, void *record, size_t size,
+                                                 const configCacheString_t *strings, size_t numStrings );
+
+// bg_pmovereplay.cpp
+#define PMOVE_RECORD_VERSION 1
+
+typedef struct
+{
+	char magic[ 4 ];
+	int  version;
+	int  playerStateSize;
+	int  pmoveExtSize;
+	int  usercmdSize;
+	char mapname[ MAX_QPATH ];
+} pmoveRecordHeader_t;
+
+typedef struct
+{
+	int           clientNum;
+	int           tracemask;
+	int           pmoveFixed;
+	int           pmoveMsec;
+	int           pmoveAccurate;
+	usercmd_t     cmd;
+	playerState_t psIn;
+	pmoveExt_t    pmextIn;
+	playerState_t psOut;
+	pmoveExt_t    pmextOut;
+} pmoveRecord_t;
+
+typedef struct
+{
+	int      moves;         // replayed per iteration
+	int      steps;         // PmoveSingle calls per iteration
+	double   nanoseconds;   // spent in PmoveSingle over all iterations
+	int      mismatches;    // moves whose output differs from the recording
+	int      firstMismatch; // -1 if none
+	uint32_t hash;          // of the outputs of the first iteration
+} pmoveReplayResult_t;
+
+void                      BG_PmoveRecordHeader( pmoveRecordHeader_t *header, const char *mapname );
+bool                      BG_PmoveRecordCompatible( const pmoveRecordHeader_t *header );
+void                      BG_PmoveReplay( const pmoveRecord_t *records, int numRecords, int iterations,
+                                          void ( *trace )( trace_t *, const vec3_t, const vec3_t, const vec3_t,
+                                                           const vec3_t, int, int, int ),
+                                          int ( *pointcontents )( const vec3_t, int ),
+                                          pmoveReplayResult_t *result );
+
 // bg_teamprogress.c
 #define NUM_UNLOCKABLES WP_NUM_WEAPONS + UP_NUM_UPGRADES + BA_NUM_BUILDABLES + PCL_NUM_CLASSES
 
@@ -146,6 +146,37 @@ void BG_MoveOriginToBBOXCenter( vec3_t point, const vec3_t mins, const vec3_t ma
 	point[ 2 ] = point[ 2 ] + ( maxs[ 2 ] + mins[ 2 ] ) * 0.5f;
 }
 
+/**
+ * @brief Gets the column or row of a horizontal grid a coordinate falls in.
+ * @param origin Coordinate where cell 0 starts.
+ */
+int BG_GridCell( float coord, float origin, float cellSize )
+{
+	return ( int ) floorf( ( coord - origin ) / cellSize );
+}
+
+/**
+ * @brief Gets the range of cells of a horizontal grid covered by bounds.
+ * @param origin Corner where cell 0, 0 starts.
+ * @param cells Receives the first column, first row, last column and last row.
+ */
+void BG_GridCells( const vec3_t origin, float cellSize, const vec3_t mins, const vec3_t maxs, int cells[ 4 ] )
+{
+	cells[ 0 ] = BG_GridCell( mins[ 0 ], origin[ 0 ], cellSize );
+	cells[ 1 ] = BG_GridCell( mins[ 1 ], origin[ 1 ], cellSize );
+	cells[ 2 ] = BG_GridCell( maxs[ 0 ], origin[ 0 ], cellSize );
+	cells[ 3 ] = BG_GridCell( maxs[ 1 ], origin[ 1 ], cellSize );
+}
+
+/**
+ * @brief Packs the column and row of a cell into a key for a hashed grid.
+ *        Both keep their low 16 bits, negative ones included.
+ */
+uint32_t BG_GridCellKey( int x, int y )
+{
+	return ( ( uint32_t ) y << 16 ) | ( ( uint32_t ) x & 0xffff );
+}
+
 void ModifyFlag(int &flags, int flag, bool value) {
 	if (value) {
 		flags |= flag;
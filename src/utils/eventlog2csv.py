@@ -0,0 +1,136 @@
+#! /usr/bin/env python3
+
+# Converts a match event log written with g_eventLog (see
+# src/sgame/sg_eventlog.cpp) to CSV.
+#
+# Usage: eventlog2csv.py <file.events> [event]
+#
+# Without an event name, writes one <file>.<event>.csv per event type next to
+# the log. With one, writes the events of that type to the standard output.
+
+import csv
+import os
+import sys
+
+VERSION = 1
+
+# Must match the schemas in sg_eventlog.cpp: (field name, kind, scale)
+# kinds are 'u' for unsigned varints and 's' for zigzag encoded ones
+EVENTS = [
+	('kill', [
+		('killer', 'u', 1), ('victim', 'u', 1), ('mod', 'u', 1),
+		('assistant', 'u', 1), ('assistantTeam', 's', 1),
+		('victimTeam', 's', 1), ('victimClass', 'u', 1),
+	]),
+	('damage', [
+		('target', 'u', 1), ('source', 'u', 1), ('mod', 'u', 1),
+		('amount', 's', 10), ('targetTeam', 's', 1),
+	]),
+	('build', [
+		('fate', 'u', 1), ('buildable', 'u', 1), ('team', 's', 1),
+		('actor', 'u', 1), ('builtBy', 'u', 1), ('momentum', 's', 10),
+		('x', 's', 1), ('y', 's', 1), ('z', 's', 1),
+	]),
+	('momentum', [
+		('team', 's', 1), ('reason', 'u', 1), ('source', 'u', 1),
+		('amount', 's', 100), ('total', 's', 100),
+	]),
+	('team', [
+		('team', 's', 1), ('players', 'u', 1), ('bots', 'u', 1),
+		('momentum', 's', 10), ('totalBudget', 's', 1), ('spentBudget', 's', 1),
+	]),
+]
+
+class Reader:
+	def __init__(self, data):
+		self.data = data
+		self.pos = 0
+
+	def done(self):
+		return self.pos >= len(self.data)
+
+	def unsigned(self):
+		value = 0
+		shift = 0
+		while True:
+			if self.pos >= len(self.data):
+				raise EOFError('truncated event log')
+			byte = self.data[self.pos]
+			self.pos += 1
+			value |= (byte & 0x7f) << shift
+			shift += 7
+			if not byte & 0x80:
+				return value
+
+	def signed(self):
+		value = self.unsigned()
+		return (value >> 1) ^ -(value & 1)
+
+	def string(self):
+		length = self.unsigned()
+		self.pos += length
+		return self.data[self.pos - length:self.pos].decode('utf-8', 'replace')
+
+def read_events(data):
+	reader = Reader(data)
+
+	if data[:4] != b'UVEV':
+		raise ValueError('not an event log')
+	reader.pos = 4
+
+	version = reader.unsigned()
+	if version != VERSION:
+		raise ValueError('unsupported event log version %d' % version)
+
+	header = {'map': reader.string(), 'date': reader.string()}
+	events = []
+	time = 0
+
+	while not reader.done():
+		kind = reader.unsigned()
+		if kind >= len(EVENTS):
+			raise ValueError('unknown event type %d at offset %d' % (kind, reader.pos))
+		time += reader.unsigned()
+
+		row = [time]
+		for name, encoding, scale in EVENTS[kind][1]:
+			value = reader.unsigned() if encoding == 'u' else reader.signed()
+			row.append(value / scale if scale != 1 else value)
+		events.append((kind, row))
+
+	return header, events
+
+def write_csv(out, kind, events):
+	writer = csv.writer(out)
+	writer.writerow(['time'] + [field[0] for field in EVENTS[kind][1]])
+	for event_kind, row in events:
+		if event_kind == kind:
+			writer.writerow(row)
+
+def main():
+	if len(sys.argv) not in (2, 3):
+		print('%s <file.events> [event]' % sys.argv[0])
+		return 1
+
+	with open(sys.argv[1], 'rb') as f:
+		header, events = read_events(f.read())
+
+	names = [event[0] for event in EVENTS]
+
+	if len(sys.argv) == 3:
+		if sys.argv[2] not in names:
+			print('unknown event %s, expected one of: %s' % (sys.argv[2], ', '.join(names)))
+			return 1
+		write_csv(sys.stdout, names.index(sys.argv[2]), events)
+		return 0
+
+	base = os.path.splitext(sys.argv[1])[0]
+	for kind, name in enumerate(names):
+		with open('%s.%s.csv' % (base, name), 'w', newline='') as out:
+			write_csv(out, kind, events)
+
+	print('%s (%s): %d events' % (header['map'], header['date'], len(events)))
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -0,0 +1,443 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2016 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished.  If not, see <http://www.gnu.org/licenses/>.
+
+===========================================================================
+*/
+
+// maprotationtest.cpp -- standalone checks of the map rotation compiler
+
+/*
+Builds sg_maprotation.cpp on its own, with just enough of the game around it
+to load a maprotation.cfg from memory, and checks which maps a few rotations
+go through when advanced: that rotations which resume each other or choose
+between others on a condition are kept, and that those which loop without one
+are dropped.
+
+  c++ -std=c++14 -o maprotationtest src/utils/maprotationtest/maprotationtest.cpp
+  ./maprotationtest
+
+Prints the cases that fail and exits with their number.
+*/
+
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+======================
+Game environment
+======================
+*/
+
+// stands in for sg_local.h
+#define SG_LOCAL_H_
+
+#define MAX_QPATH             64
+#define MAX_STRING_CHARS      1024
+#define MAX_CVAR_VALUE_STRING 256
+#define N_( x )               x
+#define Com_sprintf           snprintf
+
+typedef int fileHandle_t;
+
+enum class fsMode_t { FS_READ };
+enum team_t { TEAM_NONE, TEAM_ALIENS, TEAM_HUMANS, NUM_TEAMS };
+
+struct vmCvar_t
+{
+	int  integer;
+	char string[ MAX_CVAR_VALUE_STRING ];
+};
+
+struct gentity_t { };
+
+struct level_locals_t
+{
+	int    numConnectedClients;
+	team_t lastWin;
+};
+
+static gentity_t      g_entities[ 1 ];
+static level_locals_t level;
+static vmCvar_t       g_currentMapRotation, g_mapRotationNodes, g_mapRotationStack;
+static vmCvar_t       g_initialMapRotation, g_nextMap, g_layouts;
+
+static const char               *testMaps[] = { "a", "b", "c" };
+static std::string              testConfig;
+static std::vector<std::string> testCommands;
+static bool                     testVerbose;
+
+namespace Log {
+
+template<typename... Args> void Warn( const char *format, Args... args )
+{
+	if ( testVerbose )
+	{
+		printf( "  warning: " );
+		printf( format, args... );
+		printf( "\n" );
+	}
+}
+
+template<typename... Args> void Notice( const char *format, Args... args )
+{
+	if ( testVerbose )
+	{
+		printf( "  " );
+		printf( format, args... );
+		printf( "\n" );
+	}
+}
+
+} // namespace Log
+
+static int Q_stricmp( const char *s1, const char *s2 )
+{
+	for ( ; tolower( *s1 ) == tolower( *s2 ); s1++, s2++ )
+	{
+		if ( !*s1 )
+		{
+			return 0;
+		}
+	}
+
+	return tolower( *s1 ) - tolower( *s2 );
+}
+
+static int Q_strncmp( const char *s1, const char *s2, int n )
+{
+	return strncmp( s1, s2, n );
+}
+
+static void Q_strncpyz( char *dest, const char *src, int destsize )
+{
+	strncpy( dest, src, destsize - 1 );
+	dest[ destsize - 1 ] = 0;
+}
+
+static void Q_strcat( char *dest, int size, const char *src )
+{
+	strncat( dest, src, size - strlen( dest ) - 1 );
+}
+
+static const char *va( const char *format, ... )
+{
+	static char buffers[ 4 ][ MAX_STRING_CHARS ];
+	static int  index;
+	char        *buffer = buffers[ index++ & 3 ];
+	va_list     argptr;
+
+	va_start( argptr, format );
+	vsnprintf( buffer, MAX_STRING_CHARS, format, argptr );
+	va_end( argptr );
+
+	return buffer;
+}
+
+static const char *Quote( const char *str )
+{
+	return va( "\"%s\"", str );
+}
+
+static char *COM_ParseExt( const char **data_p, bool allowLineBreaks )
+{
+	static char token[ MAX_STRING_CHARS ];
+	const char  *data = *data_p;
+	int         len = 0;
+
+	token[ 0 ] = 0;
+
+	if ( !data )
+	{
+		return token;
+	}
+
+	while ( *data && isspace( ( unsigned char ) *data ) )
+	{
+		if ( *data == '\n' && !allowLineBreaks )
+		{
+			*data_p = data;
+			return token;
+		}
+
+		data++;
+	}
+
+	while ( *data && !isspace( ( unsigned char ) *data ) && len < MAX_STRING_CHARS - 1 )
+	{
+		token[ len++ ] = *data++;
+	}
+
+	token[ len ] = 0;
+	*data_p = data;
+
+	return token;
+}
+
+static char *COM_Parse( const char **data_p )
+{
+	return COM_ParseExt( data_p, true );
+}
+
+static void *BG_Alloc( size_t size )
+{
+	return calloc( 1, size );
+}
+
+static void BG_Free( void *ptr )
+{
+	free( ptr );
+}
+
+static const char *BG_TeamName( team_t )
+{
+	return "team";
+}
+
+static void G_MapConfigs( const char * ) { }
+static void ADMBP_begin() { }
+static void ADMBP( const char * ) { }
+static void ADMBP_end() { }
+
+static bool trap_FindPak( const char *name )
+{
+	for ( const char *map : testMaps )
+	{
+		if ( !Q_stricmp( name, va( "map-%s", map ) ) )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int trap_FS_FOpenFile( const char *, fileHandle_t *f, fsMode_t )
+{
+	if ( f )
+	{
+		*f = 1;
+	}
+
+	return testConfig.size();
+}
+
+static void trap_FS_Read( void *buffer, int len, fileHandle_t )
+{
+	memcpy( buffer, testConfig.data(), len );
+}
+
+static void trap_FS_FCloseFile( fileHandle_t ) { }
+
+static void trap_Cvar_Set( const char *name, const char *value )
+{
+	vmCvar_t *cvar = !strcmp( name, "g_currentMapRotation" ) ? &g_currentMapRotation :
+	                 !strcmp( name, "g_mapRotationNodes" ) ? &g_mapRotationNodes :
+	                 !strcmp( name, "g_mapRotationStack" ) ? &g_mapRotationStack :
+	                 !strcmp( name, "g_initialMapRotation" ) ? &g_initialMapRotation :
+	                 !strcmp( name, "g_layouts" ) ? &g_layouts : nullptr;
+
+	if ( cvar )
+	{
+		Q_strncpyz( cvar->string, value, sizeof( cvar->string ) );
+		cvar->integer = atoi( value );
+	}
+}
+
+static void trap_Cvar_Update( vmCvar_t *cvar )
+{
+	cvar->integer = atoi( cvar->string );
+}
+
+static void trap_Cvar_VariableStringBuffer( const char *, char *buffer, int bufsize )
+{
+	Q_strncpyz( buffer, "", bufsize );
+}
+
+static void trap_SendConsoleCommand( const char *text )
+{
+	testCommands.push_back( text );
+}
+
+static void trap_SendServerCommand( int, const char * ) { }
+
+void G_AdvanceMapRotation();
+bool G_StartMapRotation( const char *name, bool advance, bool putOnStack, bool reset_index );
+bool G_MapRotationActive();
+void G_InitMapRotations();
+void G_ShutdownMapRotations();
+
+#include "../../sgame/sg_maprotation.cpp"
+
+/*
+======================
+Cases
+======================
+*/
+
+struct mapRotationTest_t
+{
+	const char *name;
+	const char *config;
+	const char *rotation;
+	int        numClients;
+	const char *maps; // the maps advancing goes through, "-" when it stays on the current one
+};
+
+static const mapRotationTest_t mapRotationTests[] =
+{
+	{
+		"resume and return",
+		"main { a resume sub goto #end c #end } sub { b return }",
+		"main", 0, "a b a b a b"
+	},
+	{
+		"rotations resuming each other, few clients",
+		"small { a if numClients > 10 resume big } big { b if numClients < 10 resume small }",
+		"small", 0, "a a a a a a"
+	},
+	{
+		"rotations resuming each other, many clients",
+		"small { a if numClients > 10 resume big } big { b if numClients < 10 resume small }",
+		"small", 12, "a b b b b b"
+	},
+	{
+		"dispatcher, few clients",
+		"main { a #top if numClients > 8 goto #big if numClients < 9 goto #small goto #top #big b #small c }",
+		"main", 0, "a c a c a c"
+	},
+	{
+		"dispatcher, many clients",
+		"main { a #top if numClients > 8 goto #big if numClients < 9 goto #small goto #top #big b #small c }",
+		"main", 12, "a b c a b c"
+	},
+	{
+		"dispatcher to returning rotations, few clients",
+		"main { if numClients > 8 big if numClients < 9 small a }"
+		" big { if numClients < 9 return b } small { if numClients > 8 return c }",
+		"main", 0, "c c c c c c"
+	},
+	{
+		"dispatcher to returning rotations, many clients",
+		"main { if numClients > 8 big if numClients < 9 small a }"
+		" big { if numClients < 9 return b } small { if numClients > 8 return c }",
+		"main", 12, "b b b b b b"
+	},
+	{
+		"conditions that always loop",
+		"main { a #x if numClients > 8 goto #x goto #x }",
+		"main", 0, "a - - - - -"
+	},
+	{
+		"loop without conditions",
+		"main { a #x goto #x }",
+		"main", 0, ""
+	},
+	{
+		"rotations next to a dropped one",
+		"good { a b } loops { a #x goto #x } missing { nosuchmap a } usesmissing { resume missing b }",
+		"good", 0, "a b a b a b"
+	},
+};
+
+/*
+===============
+G_RunMapRotationTest
+
+Loads the config of a case, starts its rotation and advances it, returns the
+maps it went through
+===============
+*/
+static std::string G_RunMapRotationTest( const mapRotationTest_t *test )
+{
+	std::string maps;
+
+	memset( &level, 0, sizeof( level ) );
+	memset( &g_mapRotationNodes, 0, sizeof( g_mapRotationNodes ) );
+	memset( &g_mapRotationStack, 0, sizeof( g_mapRotationStack ) );
+	memset( &g_layouts, 0, sizeof( g_layouts ) );
+	trap_Cvar_Set( "g_currentMapRotation", va( "%d", NOT_ROTATING ) );
+	trap_Cvar_Set( "g_initialMapRotation", test->rotation );
+	level.numConnectedClients = test->numClients;
+
+	testConfig = test->config;
+	testCommands.clear();
+
+	G_InitMapRotations();
+
+	if ( G_MapRotationActive() )
+	{
+		for ( int i = 0; i < 6; i++ )
+		{
+			G_AdvanceMapRotation();
+		}
+	}
+
+	for ( const std::string &command : testCommands )
+	{
+		char name[ MAX_QPATH ];
+
+		if ( command == "map_restart" )
+		{
+			maps += maps.empty() ? "-" : " -";
+		}
+		else if ( sscanf( command.c_str(), "map \"%63[^\"]\"", name ) == 1 )
+		{
+			maps += maps.empty() ? name : std::string( " " ) + name;
+		}
+	}
+
+	G_ShutdownMapRotations();
+
+	return maps;
+}
+
+int main( int argc, char **argv )
+{
+	int failures = 0;
+
+	testVerbose = argc > 1 && !strcmp( argv[ 1 ], "-v" );
+
+	for ( const mapRotationTest_t &test : mapRotationTests )
+	{
+		if ( testVerbose )
+		{
+			printf( "%s\n", test.name );
+		}
+
+		std::string maps = G_RunMapRotationTest( &test );
+
+		if ( maps != test.maps )
+		{
+			printf( "%s: went through \"%s\", expected \"%s\"\n", test.name, maps.c_str(), test.maps );
+			failures++;
+		}
+	}
+
+	printf( "%d of %d map rotation cases failed\n", failures,
+	        ( int )( sizeof( mapRotationTests ) / sizeof( mapRotationTests[ 0 ] ) ) );
+
+	return failures;
+}
@@ -0,0 +1,243 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2016 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished.  If not, see <http://www.gnu.org/licenses/>.
+
+===========================================================================
+*/
+
+// pmovereplay.cpp -- standalone replay of recorded player moves
+
+/*
+Replays the moves recorded with g_pmoveRecord without running a game: only
+the collision data of the map is loaded, with CM_LoadMap, and the moves trace
+against it with CM_BoxTrace. The result doesn't depend on anything but the
+map, the configs and the code of Pmove, so the reported hash can be compared
+between runs and builds. Moves where the recorded player touched an entity are
+expected to differ from the recording.
+
+  pmovereplay +pmovereplay <map> <file> [iterations] +quit
+
+The shared gamelogic is linked in directly, the traps it uses are forwarded to
+the engine.
+*/
+
+#include "common/Common.h"
+#include "common/cm/cm_public.h"
+#include "engine/framework/Application.h"
+#include "engine/framework/CommandSystem.h"
+#include "engine/qcommon/qcommon.h"
+#include "shared/bg_public.h"
+
+/*
+======================
+Traps of the shared gamelogic
+======================
+*/
+
+int trap_FS_FOpenFile( const char *qpath, fileHandle_t *f, fsMode_t mode )
+{
+	return FS_FOpenFileByMode( qpath, f, mode );
+}
+
+int trap_FS_Read( void *buffer, int len, fileHandle_t f )
+{
+	return FS_Read( buffer, len, f );
+}
+
+int trap_FS_Write( const void *buffer, int len, fileHandle_t f )
+{
+	return FS_Write( buffer, len, f );
+}
+
+void trap_FS_FCloseFile( fileHandle_t f )
+{
+	FS_FCloseFile( f );
+}
+
+void trap_FS_Seek( fileHandle_t f, long offset, fsOrigin_t origin )
+{
+	FS_Seek( f, offset, origin );
+}
+
+int trap_FS_GetFileList( const char *path, const char *extension, char *listbuf, int bufsize )
+{
+	return FS_GetFileList( path, extension, listbuf, bufsize );
+}
+
+void trap_QuoteString( const char *str, char *buffer, int size )
+{
+	Cmd_QuoteStringBuffer( str, buffer, size );
+}
+
+int trap_Milliseconds()
+{
+	return Sys_Milliseconds();
+}
+
+void trap_Cvar_Set( const char *var_name, const char *value )
+{
+	Cvar_Set( var_name, value );
+}
+
+void trap_Cvar_VariableStringBuffer( const char *var_name, char *buffer, int bufsize )
+{
+	Cvar_VariableStringBuffer( var_name, buffer, bufsize );
+}
+
+int trap_Parse_LoadSource( const char *filename )
+{
+	return Parse_LoadSourceHandle( filename );
+}
+
+int trap_Parse_FreeSource( int handle )
+{
+	return Parse_FreeSourceHandle( handle );
+}
+
+bool trap_Parse_ReadToken( int handle, pc_token_t *pc_token )
+{
+	return Parse_ReadTokenHandle( handle, pc_token );
+}
+
+int trap_Parse_SourceFileAndLine( int handle, char *filename, int *line )
+{
+	return Parse_SourceFileAndLine( handle, filename, line );
+}
+
+/*
+======================
+Replay
+======================
+*/
+
+static void PmoveReplayTrace( trace_t *results, const vec3_t start, const vec3_t mins2, const vec3_t maxs2,
+                              const vec3_t end, int, int contentmask, int skipmask )
+{
+	vec3_t mins, maxs;
+
+	VectorCopy( mins2 ? mins2 : vec3_origin, mins );
+	VectorCopy( maxs2 ? maxs2 : vec3_origin, maxs );
+
+	CM_BoxTrace( results, start, end, mins, maxs, 0, contentmask, skipmask, traceType_t::TT_AABB );
+	results->entityNum = results->fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+}
+
+static int PmoveReplayPointContents( const vec3_t point, int )
+{
+	return CM_PointContents( point, 0 );
+}
+
+class PmoveReplayCmd : public Cmd::StaticCmd
+{
+public:
+	PmoveReplayCmd() : StaticCmd( "pmovereplay", Cmd::BASE, "replays moves recorded with g_pmoveRecord against a map" ) { }
+
+	void Run( const Cmd::Args &args ) const override
+	{
+		if ( args.Argc() < 3 )
+		{
+			PrintUsage( args, "<map> <file> [iterations]", "" );
+			return;
+		}
+
+		const std::string &map = args.Argv( 1 );
+		const std::string &filename = args.Argv( 2 );
+		int                numIterations = args.Argc() > 3 ? std::max( 1, atoi( args.Argv( 3 ).c_str() ) ) : 1;
+
+		FS_LoadBasePak();
+
+		if ( !FS_LoadPak( va( "map-%s", map.c_str() ) ) )
+		{
+			Print( "couldn't load the pak of %s", map.c_str() );
+			return;
+		}
+
+		CM_LoadMap( map );
+		BG_InitAllConfigs();
+
+		fileHandle_t f;
+		int          len = trap_FS_FOpenFile( filename.c_str(), &f, fsMode_t::FS_READ );
+
+		if ( len < ( int ) sizeof( pmoveRecordHeader_t ) )
+		{
+			Print( "couldn't read %s", filename.c_str() );
+
+			if ( f )
+			{
+				trap_FS_FCloseFile( f );
+			}
+
+			return;
+		}
+
+		std::vector<char> data( len );
+
+		trap_FS_Read( data.data(), len, f );
+		trap_FS_FCloseFile( f );
+
+		const pmoveRecordHeader_t *header = ( const pmoveRecordHeader_t * ) data.data();
+
+		if ( !BG_PmoveRecordCompatible( header ) )
+		{
+			Print( "%s was not recorded by a compatible build", filename.c_str() );
+			return;
+		}
+
+		if ( Q_stricmp( header->mapname, map.c_str() ) )
+		{
+			Print( "%s was recorded on %s", filename.c_str(), header->mapname );
+		}
+
+		const pmoveRecord_t *records = ( const pmoveRecord_t * )( data.data() + sizeof( pmoveRecordHeader_t ) );
+		int                 numRecords = ( len - sizeof( pmoveRecordHeader_t ) ) / sizeof( pmoveRecord_t );
+		pmoveReplayResult_t result;
+
+		BG_PmoveReplay( records, numRecords, numIterations, PmoveReplayTrace, PmoveReplayPointContents, &result );
+
+		Print( "%i moves (%i PmoveSingle) replayed %i times, %.0f ns per PmoveSingle", result.moves, result.steps,
+		       numIterations, result.steps ? result.nanoseconds / ( ( double ) result.steps * numIterations ) : 0.0 );
+		Print( "%i of %i moves differ from the recording, hash %08x", result.mismatches, result.moves, result.hash );
+
+		if ( result.mismatches )
+		{
+			Print( "first mismatch at move %i of client %i", result.firstMismatch,
+			       records[ result.firstMismatch ].clientNum );
+		}
+
+		BG_UnloadAllConfigs();
+	}
+};
+
+static PmoveReplayCmd pmoveReplayCmdRegistration;
+
+namespace Application {
+
+class PmoveReplayApplication : public Application
+{
+public:
+	PmoveReplayApplication()
+	{
+		traits.uniqueHomepathSuffix = "-pmovereplay";
+	}
+};
+
+INIT_APPLICATION( PmoveReplayApplication );
+
+} // namespace Application